@@ -0,0 +1,17 @@
+#ifndef __FOC_BENCHMARK_H__
+#define __FOC_BENCHMARK_H__
+#include "main.h"
+#include "foc_motor_control.h"
+#include "foc_observer.h"
+#include "foc_control.h"
+
+#define BENCHMARK_ANGLE_STEP    (97u)       /*电角度扫描步进（0~65535对应0~2π）*/
+
+void FOC_Benchmark_Transform(void);
+void FOC_Benchmark_SinCos(void);
+void FOC_Benchmark_SVPWM(FOC_SVPWM_t *pwm);
+void FOC_Benchmark_Observer(void);
+void FOC_Benchmark_Atan2(void);
+void FOC_Benchmark_CurrentLoop(FOC_SVPWM_t *pwm);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef __FOC_CASCADE_H__
+#define __FOC_CASCADE_H__
+#include "foc_motor_control.h"
+#include "foc_mtpa.h"
+
+/**多速率串级控制：电流环 / 速度环 / 位置环
+ * 电流环在PWM同步中断中每个周期执行，速度环、位置环按分频系数在同一中断中执行，
+ * 两者错开相位，任何一个PWM周期最多只执行一个慢速环，中断耗时不会每N个周期出现尖峰
+ */
+#define FOC_SPEED_LOOP_DIV          (20u)       /*速度环分频：20kHz / 20 = 1kHz*/
+#define FOC_POSITION_LOOP_DIV       (200u)      /*位置环分频：100Hz，须为速度环分频的整数倍*/
+#define FOC_SPEED_LOOP_PHASE        (0u)        /*速度环在分频周期内的执行位置（PWM周期）*/
+#define FOC_POSITION_LOOP_PHASE     (FOC_SPEED_LOOP_DIV / 2u)  /*位置环错开半个速度环周期*/
+
+#if (FOC_POSITION_LOOP_DIV % FOC_SPEED_LOOP_DIV) != 0 || \
+    (FOC_POSITION_LOOP_PHASE % FOC_SPEED_LOOP_DIV) == (FOC_SPEED_LOOP_PHASE % FOC_SPEED_LOOP_DIV)
+#error "speed and position loops would run in the same PWM period"
+#endif
+
+#define FOC_SPEED_BASE              (2000.0f)   /*速度Q15基值（电角速度 rad/s）*/
+#define FOC_SPEED_KP                (0.0125f)   /*速度环比例增益（A / (rad/s)）*/
+#define FOC_SPEED_KI                (0.0005f)   /*速度环积分增益（A / (rad/s)，已乘速度环周期）*/
+#define FOC_SPEED_IQ_MAX            (3.0f)      /*速度环输出q轴电流限幅（A）*/
+#define FOC_POSITION_SHIFT          (4u)        /*位置误差Q15格式：16位电角度右移4位，满量程±8圈电角度*/
+#define FOC_POSITION_KP             (20.0f)     /*位置环比例增益（1/s）*/
+#define FOC_POSITION_SPEED_MAX      (400.0f)    /*位置环输出速度限幅（电角速度 rad/s）*/
+#define FOC_SPEED_TO_Q15(x)         FOC_Sat_Q15((int32_t)((x) * (32768.0f / FOC_SPEED_BASE)))
+#define FOC_Q15_TO_SPEED(x)         ((float)(x) * (FOC_SPEED_BASE / 32768.0f))
+
+/* 单次执行耗时上限（目标板CPU周期，20kHz下一个PWM周期为3600），按FOC_PROFILE_FROM_CYCLES换算为计时源单位 */
+#define FOC_CURRENT_LOOP_CYCLE_BUDGET   (2400u) /*电流环中断整体，含本周期执行的慢速环*/
+#define FOC_SPEED_LOOP_CYCLE_BUDGET     (300u)
+#define FOC_POSITION_LOOP_CYCLE_BUDGET  (300u)
+
+/*运行方式*/
+#define FOC_CASCADE_MODE_CURRENT    0           /*只运行电流环，iq给定由外部设置*/
+#define FOC_CASCADE_MODE_SPEED      1           /*速度环输出iq给定（或经MTPA换算的dq电流给定）*/
+#define FOC_CASCADE_MODE_POSITION   2           /*位置环 -> 速度环 -> iq给定*/
+
+/*控制环编号*/
+typedef enum
+{
+    FOC_LOOP_CURRENT = 0,
+    FOC_LOOP_SPEED,
+    FOC_LOOP_POSITION,
+    FOC_LOOP_NUM
+} FOC_Loop_t;
+
+/*单个控制环的调度与超时统计（耗时单位同FOC_PROFILE_UNIT）*/
+typedef struct
+{
+    uint16_t divider;           /*执行间隔（PWM周期数）*/
+    uint16_t countdown;         /*距下次执行的PWM周期数*/
+    uint32_t budget;            /*单次执行耗时上限（FOC_PROFILE_UNIT）*/
+    uint32_t time_max;          /*单次执行最大耗时*/
+    uint32_t run_count;         /*执行次数*/
+    uint32_t overrun;           /*超出budget的次数*/
+} FOC_LoopTask_t;
+
+typedef struct
+{
+    uint8_t mode;
+    uint8_t mtpa;               /*1：速度环输出作为转矩给定，经MTPA换算为id、iq给定  0：直接作为iq给定*/
+    FOC_LoopTask_t task[FOC_LOOP_NUM];
+    FOC_PI_Q15_t pi_speed;      /*输出iq给定（Q15，基值FOC_Q15_BASE）*/
+    FOC_PI_Q15_t pi_position;   /*输出速度给定（Q15，基值FOC_SPEED_BASE）*/
+    FOC_Angle_t angle_last;     /*上个PWM周期的电角度*/
+    int64_t position;           /*多圈电角度（FOC_Angle_t单位）*/
+    int64_t position_ref;       /*位置给定*/
+    int64_t speed_position;     /*上次速度环执行时的position*/
+    int32_t speed_k;            /*速度环周期内16位电角度增量 -> 速度Q15，Q16格式*/
+    FOC_Q15_t speed;            /*速度反馈（Q15，基值FOC_SPEED_BASE）*/
+    FOC_Q15_t speed_ref;        /*速度给定（Q15，基值FOC_SPEED_BASE）*/
+} FOC_Cascade_t;
+
+void FOC_Cascade_Init(FOC_Cascade_t *cascade, FOC_Angle_t angle, float ts);
+void FOC_Cascade_SetMode(FOC_Cascade_t *cascade, uint8_t mode);
+void FOC_Cascade_Update(FOC_Cascade_t *cascade, FOC_CurrentLoop_t *loop, FOC_Angle_t angle);
+void FOC_Cascade_Record(FOC_LoopTask_t *task, uint32_t elapsed);
+void FOC_Cascade_Report(const FOC_Cascade_t *cascade);
+
+#endif
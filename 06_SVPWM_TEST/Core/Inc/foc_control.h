@@ -0,0 +1,86 @@
+#ifndef __FOC_CONTROL_H__
+#define __FOC_CONTROL_H__
+#include "main.h"
+#include "foc_motor_control.h"
+#include "foc_observer.h"
+#include "foc_cascade.h"
+#include "foc_encoder.h"
+#include "foc_hall.h"
+#include "foc_fieldweak.h"
+#include "foc_ident.h"
+#include "foc_startup.h"
+#include "foc_fault.h"
+
+#define FOC_ADC_OFFSET_SAMPLES  (64u)               /*上电电流零偏校准采样次数*/
+#define FOC_ADC_TRIGGER_LEAD    (180u)              /*ADC触发点提前PWM计数器顶点的计数值，使三相采样窗口以顶点（下管全部导通）为中心*/
+#define FOC_ADC_CURRENT_PER_LSB (0.004028f)         /*电流采样系数（A/LSB）：3.3V / 4096 / (0.01Ω * 20倍)，放大电路反相时取负值*/
+#define FOC_CURRENT_Q15_PER_LSB ((int32_t)(FOC_ADC_CURRENT_PER_LSB * (32768.0f / FOC_Q15_BASE) * 256.0f))   /*ADC计数 -> Q15电流，Q8格式*/
+#define FOC_VBUS_SAMPLES_SHIFT  (3u)
+#define FOC_VBUS_SAMPLES        (1u << FOC_VBUS_SAMPLES_SHIFT)  /*母线电压DMA循环缓冲区长度，ADC规则组连续转换*/
+#define FOC_ADC_VBUS_PER_LSB    (0.008862f)         /*母线电压采样系数（V/LSB）：3.3V / 4096 * (20k + 2k) / 2k*/
+#define FOC_VBUS_Q15_PER_LSB    ((uint32_t)(FOC_ADC_VBUS_PER_LSB * (32768.0f / FOC_Q15_BASE) * 256.0f))   /*ADC计数 -> 无符号Q15电压，Q8格式*/
+#define FOC_VBUS_FILTER_SHIFT   (3u)                /*母线电压一阶低通，时间常数约2^3个PWM周期*/
+#define FOC_CURRENT_KP          (0.5f)              /*电流环比例增益*/
+#define FOC_CURRENT_KI          (0.05f)             /*电流环积分增益（已乘控制周期）*/
+
+/**电机数（每个电机一个FOC_Control_t上下文）
+ * 电机0：TIM1（互补输出，PE8~PE13）+ ADC1（PC0~PC3），编码器TIM3/TIM4，霍尔TIM2
+ * 电机1：TIM8（CH1~CH3，PC6~PC8，驱动芯片内部产生死区；CH1N~CH3N所在PA7、PB0被编码器占用）
+ *        + ADC3（PF6~PF9），没有位置传感器
+ * 两个定时器同一时钟与周期，FOC_Control_StartPWM使TIM8滞后半个PWM周期
+ */
+#define FOC_MOTOR_COUNT         (2u)
+
+/*电角度来源*/
+#define FOC_ANGLE_SOURCE_OPENLOOP   0               /*按angle_step开环累加*/
+#define FOC_ANGLE_SOURCE_OBSERVER   1               /*无感观测器*/
+#define FOC_ANGLE_SOURCE_ENCODER    2               /*增量式编码器，index对齐后使用*/
+#define FOC_ANGLE_SOURCE_HALL       3               /*霍尔传感器*/
+
+/**FOC控制上下文（每个电机一个）
+ * 电机0：TIM1 CH4（PWM2，不输出）的OC4REF作为TRGO，在计数器顶点前触发ADC1注入组；
+ * 电机1：TIM8为中心对齐模式2（计数器向上时置比较标志），CH4比较事件在同一位置触发ADC3注入组；
+ * 注入组转换完成中断（JEOC）中完成一次电流环计算并更新比较值；
+ * 规则组连续转换母线电压，DMA循环写入vbus_adc，注入组触发时打断规则组，不影响电流采样时刻
+ */
+typedef struct
+{
+    ADC_HandleTypeDef *hadc;
+    TIM_HandleTypeDef *htim;
+    FOC_SVPWM_t svpwm;                  /*该电机逆变器的调制器*/
+    uint16_t adc_offset[3];             /*三相电流零偏（ADC计数）*/
+    uint32_t offset_sum[3];
+    uint16_t offset_count;
+    volatile uint8_t ready;             /*零偏校准完成标志*/
+    volatile uint16_t vbus_adc[FOC_VBUS_SAMPLES];   /*母线电压ADC采样，DMA循环写入*/
+    uint32_t vbus_filter;               /*母线电压低通滤波状态，左移FOC_VBUS_FILTER_SHIFT位*/
+    uint16_t udc;                       /*滤波后的母线电压（无符号Q15，32768对应FOC_Q15_BASE）*/
+    FOC_U_V_W_Q15_t i_uvw;              /*三相电流*/
+    FOC_Angle_t angle;                  /*电角度*/
+    FOC_Angle_t angle_step;             /*开环运行时每个PWM周期的电角度增量*/
+    uint8_t angle_source;               /*电角度来源*/
+    FOC_CurrentLoop_t current_loop;
+    FOC_Observer_t observer;            /*无感观测器，始终运行*/
+    FOC_Cascade_t cascade;              /*速度环、位置环，与电流环同一中断分频执行*/
+    FOC_Encoder_t encoder;              /*增量式编码器，接入时始终运行*/
+    FOC_Hall_t hall;                    /*霍尔传感器，边沿在TIM2捕获中断中处理，接入时始终运行*/
+    FOC_FieldWeak_t field_weak;         /*弱磁，使能后接管d轴电流给定*/
+    FOC_Ident_t ident;                  /*参数辨识，FOC_Ident_Start后代替电流环运行，完成后自动写入增益*/
+    FOC_Startup_t startup;              /*开环启动，FOC_Control_Startup后接管角度与电流给定，完成后切换到速度环*/
+    FOC_Fault_t fault;                  /*故障锁存与恢复，不参与电流环中断*/
+    volatile uint32_t isr_count;        /*电流环执行次数*/
+} FOC_Control_t;
+
+extern FOC_Control_t FOC_Control[FOC_MOTOR_COUNT];
+
+void FOC_Control_Init(FOC_Control_t *ctrl, ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim, TIM_HandleTypeDef *htim_encoder,
+                      TIM_HandleTypeDef *htim_edge, TIM_HandleTypeDef *htim_hall);
+void FOC_Control_StartPWM(void);
+void FOC_Control_Startup(FOC_Control_t *ctrl, uint8_t angle_source);
+void FOC_Control_ISR(FOC_Control_t *ctrl);
+uint8_t FOC_Control_Temperature(FOC_Control_t *ctrl, int16_t temperature);
+void FOC_Control_FaultTask(FOC_Control_t *ctrl);
+uint8_t FOC_Control_Recover(FOC_Control_t *ctrl);
+void FOC_Control_Debug(const FOC_Control_t *ctrl);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef __FOC_ENCODER_H__
+#define __FOC_ENCODER_H__
+#include "foc_motor_control.h"
+
+/**增量式编码器：M/T法测速 + 边沿时间戳角度插值
+ * TIM3编码器模式计数A/B（ARR = CPR - 1，计数值即一圈内的位置），CH3输入捕获index脉冲处的计数值；
+ * TIM4霍尔传感器接口模式，A/B并联接入CH1/CH2，三路输入异或后每个边沿复位计数器，
+ * CNT即为距最近一个编码器边沿的时间（定时器时钟计数）；
+ * 两个计数器在电流采样后同时读取，插值得到采样时刻的电角度
+ */
+#define FOC_ENCODER_LINES           (1000u)     /*编码器线数*/
+#define FOC_ENCODER_CPR             (FOC_ENCODER_LINES * 4u)    /*每转计数（4倍频）*/
+#define FOC_ENCODER_POLE_PAIRS      (4u)        /*电机极对数*/
+#define FOC_ENCODER_INDEX_ANGLE     (0u)        /*index脉冲处的电角度（16位，对齐d轴后标定）*/
+#define FOC_ENCODER_SPEED_WINDOW    (20u)       /*M/T测速窗口（PWM周期数），20kHz下为1ms*/
+#define FOC_ENCODER_AGE_MAX         (0x40000000u)   /*边沿时间上限，长时间静止时不再累加*/
+
+typedef struct
+{
+    TIM_HandleTypeDef *htim_count;  /*编码器模式计数，CH3捕获index*/
+    TIM_HandleTypeDef *htim_edge;   /*霍尔传感器接口模式，CNT为距最近边沿的时间*/
+    uint32_t angle_per_count;       /*每个计数对应的电角度，2^32对应2π*/
+    uint32_t period_ticks;          /*一个PWM周期的定时器时钟计数*/
+    uint32_t angle_offset;          /*计数0对应的电角度，2^32对应2π*/
+    uint16_t count;                 /*上次采样时的计数值（0 ~ CPR-1）*/
+    int8_t dir;                     /*最近一个边沿的方向：1 正转  -1 反转*/
+    uint8_t index_found;            /*已由index脉冲对齐*/
+    uint32_t edge_age;              /*采样时刻距最近一个边沿的时间*/
+    int32_t window_count;           /*测速窗口内的计数增量*/
+    uint32_t window_time;           /*测速窗口起点边沿到本次采样的时间*/
+    uint16_t window_periods;        /*测速窗口已经历的PWM周期数*/
+    int32_t speed_q32;              /*每个定时器时钟的计数增量，Q32*/
+    int32_t speed;                  /*每个PWM周期的电角度增量，2^32对应2π*/
+    FOC_Angle_t angle;              /*插值后采样时刻的电角度*/
+} FOC_Encoder_t;
+
+void FOC_Encoder_Init(FOC_Encoder_t *enc, TIM_HandleTypeDef *htim_count, TIM_HandleTypeDef *htim_edge, uint32_t period_ticks);
+void FOC_Encoder_Start(FOC_Encoder_t *enc);
+void FOC_Encoder_SetAngle(FOC_Encoder_t *enc, FOC_Angle_t angle);
+FOC_Angle_t FOC_Encoder_Update(FOC_Encoder_t *enc, uint16_t count, uint32_t edge_ticks, int32_t index_count, uint32_t delay);
+FOC_Angle_t FOC_Encoder_Read(FOC_Encoder_t *enc, uint32_t delay);
+float FOC_Encoder_GetSpeed(const FOC_Encoder_t *enc, float ts);
+
+#endif
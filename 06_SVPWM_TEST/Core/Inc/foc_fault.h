@@ -0,0 +1,82 @@
+#ifndef __FOC_FAULT_H__
+#define __FOC_FAULT_H__
+#include "foc_motor_control.h"
+#include "foc_cascade.h"
+
+/**故障保护：硬件关断 + 软件故障锁存与受控恢复
+ * 关断全部由硬件或故障源自己的中断完成，电流环中断不做任何故障判断，正常运行时没有额外耗时：
+ * 1. 过流：外部比较器输出接TIM1_BKIN（PE15，高有效），刹车输入有效时定时器硬件异步清除MOE，
+ *    六路输出立即进入空闲电平（OSSI = 1，上下管全部关断），不经过CPU；AOE = 0，MOE保持清除直到软件恢复；
+ *    随后的刹车中断只做记录（FOC_Fault_Break）
+ * 2. 过压：母线电压所在的ADC规则组配置模拟看门狗，超出上限时在看门狗中断中软件刹车（FOC_Fault_Trigger）
+ * 3. 过温：慢速任务按温度采样调用FOC_Fault_CheckTemperature，超过上限时软件刹车
+ * 软件刹车：EGR.BG产生刹车事件，效果与刹车输入相同；TIM8的BKIN（PA6）被编码器定时器占用，电机1只有软件刹车
+ * 锁存：第一次故障记录原因与时间（HAL_GetTick毫秒数与FOC_Profile_Now计数），锁存期间的后续故障只累加原因；
+ *    每次故障另记入环形日志，供事后查看
+ * 恢复（FOC_Fault_Recover，不在中断中调用）：锁存至少FOC_FAULT_RECOVER_DELAY，且刹车输入已撤销、
+ *    母线电压与温度回到恢复门限以内，才复位电流环与串级控制（电流给定为0）并重新使能MOE，
+ *    进入确认阶段；FOC_FAULT_CONFIRM_TIME内没有再次故障则回到正常状态，之后才允许重新启动；
+ *    恢复后FOC_FAULT_RETRY_CLEAR内再次故障计为重试，超过FOC_FAULT_RETRY_MAX次锁死，只能复位解除
+ */
+#define FOC_FAULT_UDC_TRIP          (16.0f)     /*过压门限（V），模拟看门狗上限*/
+#define FOC_FAULT_UDC_RECOVER       (14.0f)     /*允许恢复的母线电压（V）*/
+#define FOC_FAULT_TEMP_TRIP         (850)       /*过温门限（0.1°C）*/
+#define FOC_FAULT_TEMP_RECOVER      (700)       /*允许恢复的温度（0.1°C）*/
+#define FOC_FAULT_RECOVER_DELAY     (500u)      /*锁存后最短等待时间（ms）*/
+#define FOC_FAULT_CONFIRM_TIME      (100u)      /*恢复后零电流确认时间（ms）*/
+#define FOC_FAULT_RETRY_MAX         (3u)        /*连续恢复次数上限，超过后锁死*/
+#define FOC_FAULT_RETRY_CLEAR       (10000u)    /*恢复后连续无故障运行该时间（ms）后清除重试计数*/
+#define FOC_FAULT_LOG_SIZE          (8u)        /*故障日志条数，须为2的幂*/
+
+/*故障原因（可组合）*/
+#define FOC_FAULT_OVERCURRENT       0x01u       /*刹车输入（硬件过流比较器）*/
+#define FOC_FAULT_OVERVOLTAGE       0x02u       /*母线电压模拟看门狗*/
+#define FOC_FAULT_OVERTEMP          0x04u       /*温度*/
+#define FOC_FAULT_CAUSE_NUM         3u
+
+/*故障状态*/
+#define FOC_FAULT_STATE_NONE        0           /*正常*/
+#define FOC_FAULT_STATE_LATCHED     1           /*已关断，等待恢复*/
+#define FOC_FAULT_STATE_CONFIRM     2           /*已恢复输出，零电流确认中*/
+#define FOC_FAULT_STATE_LOCKED      3           /*重试次数用尽，只能复位解除*/
+
+/*FOC_Fault_Recover的返回值：0为已开始恢复，否则为仍然存在的故障原因，或以下之一*/
+#define FOC_FAULT_RECOVER_OK        0x00u
+#define FOC_FAULT_RECOVER_WAIT      0x40u       /*锁存时间不足FOC_FAULT_RECOVER_DELAY*/
+#define FOC_FAULT_RECOVER_DENIED    0x80u       /*不在锁存状态（正常、确认中或已锁死）*/
+
+/*故障日志条目*/
+typedef struct
+{
+    uint8_t cause;
+    uint8_t state;              /*记录前的状态*/
+    uint32_t tick;              /*HAL_GetTick（ms）*/
+    uint32_t cycle;             /*FOC_Profile_Now，同一毫秒内区分先后*/
+} FOC_FaultRecord_t;
+
+typedef struct
+{
+    TIM_HandleTypeDef *htim;
+    uint8_t break_input;        /*1：该定时器的刹车输入已使能（tim.c中BreakState）*/
+    volatile uint8_t state;
+    volatile uint8_t cause;     /*本次锁存以来出现过的故障原因*/
+    uint8_t first;              /*本次锁存的第一个故障原因*/
+    uint8_t retry;              /*连续恢复次数*/
+    uint32_t tick, cycle;       /*本次锁存的时间*/
+    uint32_t recover_tick;      /*最近一次恢复的时间*/
+    uint16_t udc_recover;       /*允许恢复的母线电压（无符号Q15）*/
+    int16_t temperature;        /*最近一次温度采样（0.1°C）*/
+    uint16_t count[FOC_FAULT_CAUSE_NUM];        /*各原因累计次数*/
+    FOC_FaultRecord_t log[FOC_FAULT_LOG_SIZE];  /*环形日志*/
+    uint16_t log_count;         /*累计记录条数，最新一条为log[(log_count - 1) % FOC_FAULT_LOG_SIZE]*/
+} FOC_Fault_t;
+
+void FOC_Fault_Init(FOC_Fault_t *fault, TIM_HandleTypeDef *htim);
+void FOC_Fault_Break(FOC_Fault_t *fault);
+void FOC_Fault_Trigger(FOC_Fault_t *fault, uint8_t cause);
+uint8_t FOC_Fault_CheckTemperature(FOC_Fault_t *fault, int16_t temperature);
+uint8_t FOC_Fault_Recover(FOC_Fault_t *fault, FOC_CurrentLoop_t *loop, FOC_Cascade_t *cascade, uint16_t udc);
+void FOC_Fault_Task(FOC_Fault_t *fault);
+void FOC_Fault_Report(const FOC_Fault_t *fault);
+
+#endif
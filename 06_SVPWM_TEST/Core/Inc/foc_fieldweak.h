@@ -0,0 +1,35 @@
+#ifndef __FOC_FIELDWEAK_H__
+#define __FOC_FIELDWEAK_H__
+#include "foc_motor_control.h"
+
+/**弱磁控制：电压裕量反馈
+ * 调制度（Tx + Ty相对可用六边形）超过给定时积分出负的d轴电流，反电势抵消后恢复电压裕量；
+ * 调制度低于给定时id积分回0，基速以下不起作用；
+ * q轴电流给定按电流圆 iq² ≤ Imax² - id² 限幅，Imax为FOC_FW_I_MAX减去FOC_FW_I_MARGIN：
+ * 电压饱和附近电流环的跟踪纹波叠加在给定上，给定留出裕量后实际电流幅值才不超过FOC_FW_I_MAX；
+ * 初始化后默认关闭，FOC_FieldWeak_Enable使能后接管d轴电流给定
+ */
+#define FOC_FW_MODULATION_REF       (0.95f)     /*调制度给定，留5%裕量给电流环动态调节*/
+#define FOC_FW_KI                   (0.02f)     /*积分增益：每个PWM周期每单位调制度误差的id增量（A）*/
+#define FOC_FW_ID_MIN               (-3.0f)     /*弱磁电流下限（A）*/
+#define FOC_FW_I_MAX                (3.0f)      /*电流圆半径（A），实际电流幅值上限*/
+#define FOC_FW_I_MARGIN             (0.1f)      /*给定电流圆相对FOC_FW_I_MAX的裕量（A），须大于弱磁稳态下的电流跟踪纹波*/
+
+typedef struct
+{
+    uint8_t enable;
+    uint16_t modulation_ref;    /*调制度给定（Q15，32768对应六边形边界）*/
+    uint16_t modulation;        /*上一个PWM周期的调制度*/
+    int32_t ki;                 /*积分增益，FOC_PI_SHIFT格式*/
+    int32_t integral;           /*id积分值，Q15左移FOC_PI_SHIFT位*/
+    int32_t integral_min;       /*积分下限（FOC_FW_ID_MIN，不超出给定电流圆）*/
+    uint32_t i_max_sq;          /*给定电流圆半径平方（Q15²）*/
+    FOC_Q15_t id_ref;           /*弱磁d轴电流给定*/
+    FOC_Q15_t iq_max;           /*电流圆内的q轴电流上限*/
+} FOC_FieldWeak_t;
+
+void FOC_FieldWeak_Init(FOC_FieldWeak_t *fw);
+void FOC_FieldWeak_Enable(FOC_FieldWeak_t *fw, uint8_t enable);
+void FOC_FieldWeak_Update(FOC_FieldWeak_t *fw, FOC_CurrentLoop_t *loop);
+
+#endif
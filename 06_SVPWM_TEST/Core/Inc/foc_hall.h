@@ -0,0 +1,54 @@
+#ifndef __FOC_HALL_H__
+#define __FOC_HALL_H__
+#include "foc_motor_control.h"
+
+/**霍尔传感器：60°扇区角度 + 扇区内按上一个扇区时间插值
+ * TIM2霍尔传感器接口模式（完全重映射，H1/H2/H3接PA15/PB3/PB10），三路输入异或后
+ * 每个边沿复位计数器并把复位前的计数值捕获到CCR1：CCR1为上一个扇区的时间，CNT为进入当前扇区后的时间；
+ * 边沿中断只做查表与一次除法，耗时与转速无关；角度插值在电流环中断中完成
+ */
+#define FOC_HALL_TIM_PRESCALER      (71u)       /*霍尔定时器预分频，72MHz / 72 = 1MHz*/
+#define FOC_HALL_ANGLE_OFFSET       (0u)        /*扇区0起始边沿处的电角度（16位，对齐d轴后标定）*/
+#define FOC_HALL_TIMEOUT            (1200u)     /*超过该PWM周期数（60ms）无边沿视为静止，须小于定时器溢出时间65.5ms*/
+#define FOC_HALL_SECTOR_ANGLE       (0x2AAAAAAAu)   /*60°，2^32对应2π*/
+#define FOC_HALL_INVALID            (0xFFu)
+
+/*霍尔状态（H1 | H2<<1 | H3<<2）-> 扇区编号，正转顺序 5 1 3 2 6 4，0和7为故障状态*/
+#define FOC_HALL_SECTOR_TABLE       {FOC_HALL_INVALID, 1u, 3u, 2u, 5u, 0u, 4u, FOC_HALL_INVALID}
+
+/*霍尔输入引脚，边沿中断中读取状态*/
+#define FOC_HALL_H1_PORT            GPIOA
+#define FOC_HALL_H1_PIN             GPIO_PIN_15
+#define FOC_HALL_H2_PORT            GPIOB
+#define FOC_HALL_H2_PIN             GPIO_PIN_3
+#define FOC_HALL_H3_PORT            GPIOB
+#define FOC_HALL_H3_PIN             GPIO_PIN_10
+
+typedef struct
+{
+    TIM_HandleTypeDef *htim;        /*霍尔传感器接口模式定时器*/
+    uint32_t pwm_ticks_q8;          /*一个PWM周期的霍尔定时器计数，Q8*/
+    uint8_t state;                  /*霍尔状态*/
+    uint8_t sector;                 /*当前扇区（0~5）*/
+    int8_t dir;                     /*1 正转  -1 反转  0 未知*/
+    uint8_t speed_valid;            /*连续两个同向边沿后有效*/
+    uint32_t edge_angle;            /*进入当前扇区的边沿处电角度，2^32对应2π*/
+    uint32_t angle_per_tick;        /*扇区内每个定时器计数的电角度增量，2^32对应2π*/
+    uint16_t period;                /*上一个扇区的时间（定时器计数）*/
+    int32_t speed;                  /*每个PWM周期的电角度增量，2^32对应2π*/
+    volatile uint32_t edge_count;   /*边沿计数，电流环据此判断是否有新边沿*/
+    uint32_t edge_seen;             /*电流环上次看到的edge_count*/
+    uint16_t age;                   /*距最近一个边沿的PWM周期数*/
+    uint32_t error_count;           /*故障状态或跳扇区次数*/
+    FOC_Angle_t angle;              /*插值后的电角度*/
+} FOC_Hall_t;
+
+void FOC_Hall_Init(FOC_Hall_t *hall, TIM_HandleTypeDef *htim, uint32_t period_ticks);
+void FOC_Hall_Start(FOC_Hall_t *hall);
+void FOC_Hall_Edge(FOC_Hall_t *hall, uint8_t state, uint16_t period);
+void FOC_Hall_Capture(FOC_Hall_t *hall);
+FOC_Angle_t FOC_Hall_Update(FOC_Hall_t *hall, uint32_t elapsed);
+FOC_Angle_t FOC_Hall_Read(FOC_Hall_t *hall, uint32_t delay);
+float FOC_Hall_GetSpeed(const FOC_Hall_t *hall, float ts);
+
+#endif
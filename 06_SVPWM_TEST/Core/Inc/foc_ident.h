@@ -0,0 +1,68 @@
+#ifndef __FOC_IDENT_H__
+#define __FOC_IDENT_H__
+#include "foc_motor_control.h"
+#include "foc_observer.h"
+
+/**电机参数辨识（调试模式），在电流环中断中代替正常控制运行，不需要位置传感器
+ * 1. 定位：d轴通直流把转子拉到电角度0
+ * 2. 电阻：d轴两档直流，Rs = ΔUd / ΔId，逆变器压降与死区误差在差值中抵消
+ * 3. 电感：保持直流的同时在d轴、q轴分别注入方波电压，L = Uh * Δt / Δi，转子不动
+ * 4. 磁链：I/f开环旋转（电流矢量按给定转速旋转），由稳态电压、电流与已知Rs、Ld、Lq解出负载角与ψ
+ * 结束后按辨识结果计算电流环PI增益（零极点对消，带宽FOC_IDENT_CURRENT_BW）与观测器参数
+ */
+#define FOC_IDENT_CURRENT           (1.5f)      /*定位与电阻测试电流（A），低档取一半*/
+#define FOC_IDENT_ALIGN_TIME        (0.5f)      /*定位时间（s）*/
+#define FOC_IDENT_SETTLE_TIME       (0.1f)      /*每一步的稳定时间（s）*/
+#define FOC_IDENT_MEASURE_TIME      (0.1f)      /*每一步的测量时间（s）*/
+#define FOC_IDENT_HF_VOLTAGE        (2.0f)      /*注入方波幅值（V）*/
+#define FOC_IDENT_HF_HALF           (4u)        /*注入方波半周期（PWM周期数），20kHz下2.5kHz方波*/
+#define FOC_IDENT_SPIN_CURRENT      (2.0f)      /*I/f旋转电流（A），须能克服负载与摩擦*/
+#define FOC_IDENT_SPIN_SPEED        (200.0f)    /*I/f旋转电角速度（rad/s）*/
+#define FOC_IDENT_SPIN_RAMP_TIME    (0.5f)      /*I/f加速时间（s）*/
+#define FOC_IDENT_CURRENT_BW        (2000.0f)   /*电流环带宽（rad/s），Kp = L * ωc，Ki = Rs * ωc * Ts*/
+
+/*辨识状态*/
+#define FOC_IDENT_IDLE      0
+#define FOC_IDENT_ALIGN     1
+#define FOC_IDENT_RS_LOW    2
+#define FOC_IDENT_RS_HIGH   3
+#define FOC_IDENT_HF_D      4
+#define FOC_IDENT_HF_Q      5
+#define FOC_IDENT_SPIN      6
+#define FOC_IDENT_DONE      7
+#define FOC_IDENT_FAULT     8               /*测量结果不合理（接线、电流采样或参数设置问题）*/
+
+typedef struct
+{
+    volatile uint8_t state;
+    uint32_t count;                 /*当前步骤已执行的PWM周期数*/
+    float ts;                       /*PWM周期（s）*/
+    uint32_t n_align, n_settle, n_measure, n_ramp;
+    FOC_Q15_t current;              /*测试电流*/
+    FOC_Q15_t hf_voltage;           /*注入幅值*/
+    FOC_Q15_t spin_current;
+    uint32_t spin_step;             /*I/f稳态每个PWM周期的角度增量，2^32对应2π*/
+    uint32_t theta;                 /*I/f角度累加器，2^32对应2π*/
+    FOC_Angle_t angle;              /*施加电压的电角度*/
+    /* 测量累加 */
+    int32_t sum_vd, sum_vq, sum_id, sum_iq;
+    uint32_t n;
+    FOC_D_Q_Q15_t v_hold;           /*大档直流对应的dq电压，注入时保持*/
+    FOC_Q15_t i_mark;               /*注入半周期起点电流*/
+    int32_t sum_di;                 /*注入半周期电流变化量累加*/
+    uint32_t n_di;
+    float v_low, i_low;
+    /* 辨识结果 */
+    float rs;                       /*相电阻（Ω）*/
+    float ld, lq;                   /*dq轴电感（H）*/
+    float flux;                     /*永磁体磁链（Wb），反电势常数 = ψ * 极对数（V·s/rad，机械）*/
+    float kp_d, ki_d, kp_q, ki_q;   /*电流环PI增益，同FOC_CurrentLoop_Init单位*/
+} FOC_Ident_t;
+
+void FOC_Ident_Init(FOC_Ident_t *ident, float ts);
+void FOC_Ident_Start(FOC_Ident_t *ident);
+uint8_t FOC_Ident_Busy(const FOC_Ident_t *ident);
+const FOC_PWMCounter_t *FOC_Ident_Update(FOC_Ident_t *ident, FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw);
+void FOC_Ident_Apply(const FOC_Ident_t *ident, FOC_CurrentLoop_t *loop, FOC_Observer_t *obs);
+
+#endif
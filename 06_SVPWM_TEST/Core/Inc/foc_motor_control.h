@@ -5,6 +5,9 @@
 #include "stddef.h"
 #include "math.h"
 #include "debug.h"
+#include "foc_ramfunc.h"
+#include "foc_profile.h"
+#include "foc_sin_config.h"
 #include "stm32f1xx_hal_tim.h"
 
 #define _PI_2               1.57079632679f          /*π/2*/
@@ -15,9 +18,89 @@
 #define _1_DIV_SQRT_3       0.577350269189625f      /*1除根号3*/
 #define _2_DIV_SQRT_3       1.154700538379251f      /*2除根号3*/
 
-#define MAXPWM_DUTY_CYCLE   (5000.0f)
-#define MAXPWM_CONTROL      (5000.0f)
-#define UDC                 (12.0f)
+#define FOC_PWM_MIN_PULSE   (36u)                   /*上下管最小导通时间（定时器计数值），72MHz下为0.5us*/
+#define UDC                 (12.0f)                 /*额定母线电压，即Q15电压基值；实际母线电压由FOC_SVPWM_SetBusVoltage更新*/
+#define FOC_BUS_UDC_MIN     (16384u)                /*母线电压前馈下限（0.5 * UDC），低于此值按下限计算*/
+
+/* 变换链运算方式选择：1 使用Q15定点运算  0 使用浮点运算 */
+#ifndef FOC_USE_Q15
+#define FOC_USE_Q15         0
+#endif
+#define FOC_Q15_BASE        UDC                     /*Q15标幺基值，Q15的1.0对应FOC_Q15_BASE*/
+#define FOC_FLOAT_TO_Q15(x) FOC_Sat_Q15((int32_t)((x) * (32768.0f / FOC_Q15_BASE)))
+#define FOC_Q15_TO_FLOAT(x) ((float)(x) * (FOC_Q15_BASE / 32768.0f))
+
+/* SVPWM实现方式选择 */
+#define FOC_SVPWM_MODE_SECTOR   0                   /*扇区判断 + 七段式矢量作用时间*/
+#define FOC_SVPWM_MODE_MINMAX   1                   /*最大最小值零序注入，无扇区判断*/
+#ifndef FOC_SVPWM_MODE
+#define FOC_SVPWM_MODE      FOC_SVPWM_MODE_SECTOR
+#endif
+
+/**过调制方式（可由FOC_SVPWM_SetOvermodulation运行时切换）
+ * 电压幅值m以Udc为基值，线性区上限 1/√3 = 0.5774，六步方波基波 2/π = 0.6366
+ */
+#define FOC_OVERMOD_NONE        0                   /*不处理，超出六边形的部分按比例缩小*/
+#define FOC_OVERMOD_REGION1     1                   /*I区：幅值补偿，基波最大0.6057（调制比0.9514）*/
+#define FOC_OVERMOD_SIXSTEP     2                   /*I区 + II区角度保持，平滑过渡到六步方波*/
+#ifndef FOC_OVERMOD_MODE
+#define FOC_OVERMOD_MODE    FOC_OVERMOD_NONE
+#endif
+#define FOC_OVERMOD_TABLE_SIZE  32                  /*I区、II区查表分段数*/
+
+/**不连续调制（可由FOC_SVPWM_SetDiscontinuous运行时切换）
+ * 在连续SVPWM比较值上叠加同一个零序偏移，使一相钳位在100%或0%，该相整段不开关
+ */
+#define FOC_DPWM_NONE       0                       /*连续SVPWM*/
+#define FOC_DPWM_0          1                       /*每相电压峰值前的60°钳位（相对DPWM1超前30°）*/
+#define FOC_DPWM_1          2                       /*绝对值最大的一相钳位，以相电压峰值为中心的60°*/
+#define FOC_DPWM_MAX        3                       /*电压最高的一相钳位到100%，每相120°*/
+#ifndef FOC_DPWM_MODE
+#define FOC_DPWM_MODE       FOC_DPWM_NONE
+#endif
+
+/* 死区补偿：按相电流符号给比较值加减半个死区，|i| < FOC_DTC_CURRENT_BAND 时线性过渡 */
+#ifndef FOC_DTC_ENABLE
+#define FOC_DTC_ENABLE      1
+#endif
+#define FOC_DTC_CURRENT_BAND    (0.1f)              /*过零过渡带（A）*/
+
+#define FOC_PI_SHIFT        12                      /*PI增益定点格式：整数增益 = 实际增益 * 2^12*/
+
+/**CORDIC向量模式迭代次数（8~16），每次迭代约8个周期
+ * 16次：角度误差 < 1 LSB（16位电角度），幅值误差 < 1 LSB（Q15）
+ */
+#ifndef FOC_CORDIC_ITERATIONS
+#define FOC_CORDIC_ITERATIONS   16
+#endif
+
+typedef int16_t FOC_Q15_t;
+typedef int32_t FOC_Q31_t;
+
+/**电角度：无符号整数，2π对应整数的自然溢出，加减即回绕
+ * FOC_ANGLE_BITS = 16: 0~65535 对应 0~2π
+ * FOC_ANGLE_BITS = 32: 0~4294967295 对应 0~2π
+ */
+#ifndef FOC_ANGLE_BITS
+#define FOC_ANGLE_BITS      16
+#endif
+
+#if FOC_ANGLE_BITS == 32
+typedef uint32_t FOC_Angle_t;
+typedef int32_t FOC_AngleDiff_t;
+#define FOC_ANGLE_PER_RAD   683565275.5764316f      /*2^32 / 2π*/
+#elif FOC_ANGLE_BITS == 16
+typedef uint16_t FOC_Angle_t;
+typedef int16_t FOC_AngleDiff_t;
+#define FOC_ANGLE_PER_RAD   10430.378350470453f     /*2^16 / 2π*/
+#else
+#error "FOC_ANGLE_BITS must be 16 or 32"
+#endif
+#define FOC_RAD_PER_ANGLE   (1.0f / FOC_ANGLE_PER_RAD)
+#define FOC_ANGLE_2PI_3     ((FOC_Angle_t)(0x55555555u >> (32 - FOC_ANGLE_BITS)))   /*120°*/
+#define FOC_ANGLE_PI_2      ((FOC_Angle_t)(0x40000000u >> (32 - FOC_ANGLE_BITS)))   /*90°*/
+#define FOC_ANGLE_FROM_U16(x) ((FOC_Angle_t)((FOC_Angle_t)(x) << (FOC_ANGLE_BITS - 16)))
+#define FOC_ANGLE_TO_U16(x)   ((uint16_t)((x) >> (FOC_ANGLE_BITS - 16)))
 
 
 /* 三相坐标系*/
@@ -42,27 +125,191 @@ typedef struct
     float iq;
 } FOC_D_Q_t;
 
-/*非零矢量作用时间*/
+/* 三相坐标系（Q15定点）*/
+typedef struct
+{
+    FOC_Q15_t iu;
+    FOC_Q15_t iv;
+    FOC_Q15_t iw;
+} FOC_U_V_W_Q15_t;
+
+/* alpha beta 坐标系（Q15定点）*/
+typedef struct
+{
+    FOC_Q15_t alpha;
+    FOC_Q15_t beta;
+} FOC_Alpha_Beta_Q15_t;
+
+/*d q坐标系（Q15定点）*/
+typedef struct
+{
+    FOC_Q15_t id;
+    FOC_Q15_t iq;
+} FOC_D_Q_Q15_t;
+
+/*非零矢量作用时间（Q15，32768对应一个PWM周期）*/
 typedef struct
 {
-    float t0;
-    float t1;
-    float t2;
+    uint16_t t0;
+    uint16_t t1;
+    uint16_t t2;
 } FOC_VectorTime_t;
 
 /*PWM计数器CCR*/
 typedef struct
 {
-    float counter_0;
-    float counter_1;
-    float counter_2;
+    uint16_t counter_0;
+    uint16_t counter_1;
+    uint16_t counter_2;
 } FOC_PWMCounter_t;
 
+/*PWM计数参数（由定时器配置计算）*/
+typedef struct
+{
+    uint16_t period;        /*ARR*/
+    uint16_t deadtime;      /*死区时间（计数值）*/
+    uint16_t compare_min;   /*比较值下限*/
+    uint16_t compare_max;   /*比较值上限*/
+    uint16_t span_max;      /*比较值限幅内可输出的最大线电压（Q15，32768对应Udc），即可用六边形的大小*/
+    uint16_t span_inv;      /*span_max的倒数，Q14*/
+    uint16_t dtc_offset;    /*死区补偿比较值偏移（计数值），半个死区*/
+    uint32_t dtc_slope;     /*过渡带内偏移/电流斜率，Q16*/
+} FOC_PWMConfig_t;
+
+/**母线电压前馈参数（每个控制周期由FOC_SVPWM_SetBusVoltage更新一次）
+ * 调制器输入的电压以FOC_Q15_BASE为基值，乘以udc_inv换算为实际母线电压的标幺值，
+ * 热路径上只有乘法
+ */
+typedef struct
+{
+    uint16_t udc;           /*母线电压，无符号Q15（32768对应FOC_Q15_BASE，最大2倍）*/
+    uint16_t udc_inv;       /*FOC_Q15_BASE / udc，Q14*/
+    uint16_t span;          /*可用六边形大小换算到FOC_Q15_BASE基值（Q15）*/
+    uint16_t span_inv;      /*span的倒数，Q14*/
+    FOC_Q15_t v_limit;      /*当前过调制方式下的最大电压幅值（Q15，基值FOC_Q15_BASE）*/
+} FOC_BusVoltage_t;
+
+/**SVPWM调制器（每个逆变器一个，由FOC_SVPWM_Init按所驱动的定时器初始化）
+ * 定时器参数、母线电压前馈、过调制与DPWM方式、调制度都在这里，
+ * 调制相关函数以它为第一个参数，多个电机的调制器互不影响
+ */
+typedef struct
+{
+    TIM_HandleTypeDef *htim;    /*PWM定时器*/
+    FOC_PWMConfig_t config;     /*PWM计数参数，由定时器实际配置计算*/
+    FOC_BusVoltage_t bus;       /*母线电压前馈参数，由FOC_SVPWM_SetBusVoltage每个控制周期更新*/
+    int32_t time_sum;           /*最近一次调制的 Tx + Ty（限幅前，Q15，32768对应一个PWM周期），弱磁据此判断电压裕量*/
+    uint8_t overmod;            /*过调制方式*/
+    uint8_t dpwm;               /*不连续调制方式*/
+} FOC_SVPWM_t;
+
+/*PI控制器（Q15定点）*/
+typedef struct
+{
+    int32_t kp;             /*比例增益，FOC_PI_SHIFT格式*/
+    int32_t ki;             /*积分增益（已乘采样周期），FOC_PI_SHIFT格式*/
+    int32_t integral;       /*积分累加值，Q15左移FOC_PI_SHIFT位*/
+    FOC_Q15_t out_max;      /*输出限幅*/
+} FOC_PI_Q15_t;
+
+/*电流环（Q15定点）：Clarke -> Park -> PI -> Park逆变换 -> SVPWM*/
+typedef struct
+{
+    FOC_SVPWM_t *pwm;                   /*该电机逆变器的调制器*/
+    FOC_PI_Q15_t pi_d;
+    FOC_PI_Q15_t pi_q;
+    FOC_D_Q_Q15_t i_ref;                /*dq电流给定*/
+    FOC_Alpha_Beta_Q15_t i_AlphaBeta;   /*alpha beta电流反馈*/
+    FOC_D_Q_Q15_t i_dq;                 /*dq电流反馈*/
+    FOC_D_Q_Q15_t v_dq;                 /*dq电压输出*/
+    FOC_Alpha_Beta_Q15_t v_AlphaBeta;   /*alpha beta电压输出*/
+    FOC_PWMCounter_t counter;           /*三相比较值*/
+} FOC_CurrentLoop_t;
+
+/* Q15饱和，M3上编译器会生成SSAT指令 */
+static inline FOC_Q15_t FOC_Sat_Q15(FOC_Q31_t x)
+{
+    if (x > 32767)
+    {
+        return 32767;
+    }
+    if (x < -32768)
+    {
+        return -32768;
+    }
+    return (FOC_Q15_t)x;
+}
+
+/* 弧度制 -> 整数电角度，任意正负弧度都会回绕到0~2π */
+static inline FOC_Angle_t FOC_Angle_FromRad(float rad)
+{
+#if FOC_ANGLE_BITS == 32
+    return (FOC_Angle_t)(int64_t)(rad * FOC_ANGLE_PER_RAD);
+#else
+    return (FOC_Angle_t)(int32_t)(rad * FOC_ANGLE_PER_RAD);
+#endif
+}
+
+/* 整数电角度 -> 弧度制（0~2π） */
+static inline float FOC_Angle_ToRad(FOC_Angle_t angle)
+{
+    return (float)angle * FOC_RAD_PER_ANGLE;
+}
+
+/* 两个电角度的有符号差值（-π~π） */
+static inline FOC_AngleDiff_t FOC_Angle_Diff(FOC_Angle_t a, FOC_Angle_t b)
+{
+    return (FOC_AngleDiff_t)(FOC_Angle_t)(a - b);
+}
+
+FOC_Alpha_Beta_t FOC_Clarke_Transform(const FOC_U_V_W_t *i_uvw);
+FOC_D_Q_t FOC_Park_Transform(const FOC_Alpha_Beta_t *i_AlphaBeta, const FOC_Angle_t ElectricalAngle);
+FOC_Alpha_Beta_t FOC_Inverse_Park_Transform(const FOC_D_Q_t *i_DQ, const FOC_Angle_t ElectricalAngle);
+FOC_U_V_W_t FOC_Inverse_Clarke_Transform(const FOC_Alpha_Beta_t *i_AlphaBeta);
+
+void FOC_SinCos(FOC_Angle_t ElectricalAngle, float *sinVal, float *cosVal);
+void FOC_SinCos_Q15(FOC_Angle_t ElectricalAngle, FOC_Q15_t *sinVal, FOC_Q15_t *cosVal);
+FOC_Q31_t FOC_Polar_Q15(const FOC_Alpha_Beta_Q15_t *i_AlphaBeta, FOC_Angle_t *ElectricalAngle);
+FOC_Angle_t FOC_Atan2_Q15(FOC_Q15_t y, FOC_Q15_t x);
+FOC_Q31_t FOC_Magnitude_Q15(FOC_Q15_t x, FOC_Q15_t y);
+FOC_Alpha_Beta_Q15_t FOC_Clarke_Transform_Q15(const FOC_U_V_W_Q15_t *i_uvw);
+FOC_D_Q_Q15_t FOC_Park_Transform_Q15(const FOC_Alpha_Beta_Q15_t *i_AlphaBeta, FOC_Angle_t ElectricalAngle);
+FOC_Alpha_Beta_Q15_t FOC_Inverse_Park_Transform_Q15(const FOC_D_Q_Q15_t *i_DQ, FOC_Angle_t ElectricalAngle);
+FOC_U_V_W_Q15_t FOC_Inverse_Clarke_Transform_Q15(const FOC_Alpha_Beta_Q15_t *i_AlphaBeta);
+
+uint16_t FOC_SVPWM_GetDeadTimeTicks(const TIM_HandleTypeDef *htim);
+void FOC_SVPWM_Init(FOC_SVPWM_t *pwm, TIM_HandleTypeDef *htim);
+const FOC_PWMConfig_t *FOC_SVPWM_GetConfig(const FOC_SVPWM_t *pwm);
+void FOC_SVPWM_SetBusVoltage(FOC_SVPWM_t *pwm, uint16_t udc);
+const FOC_BusVoltage_t *FOC_SVPWM_GetBusVoltage(const FOC_SVPWM_t *pwm);
+uint16_t FOC_SVPWM_GetModulation(const FOC_SVPWM_t *pwm);
+uint8_t FOC_SVPWM_GetSector(const FOC_Alpha_Beta_t *I_AlphaBeta);
+FOC_VectorTime_t FOC_SVPWM_GetVectorTime(FOC_SVPWM_t *pwm, uint8_t sector, FOC_Alpha_Beta_t *I_AlphaBeta);
+FOC_PWMCounter_t FOC_SVPWM_GetPWMCounter(const FOC_SVPWM_t *pwm, uint8_t sector, const FOC_VectorTime_t *t_VectorTime);
+FOC_PWMCounter_t FOC_SVPWM_MinMax(FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_t *I_AlphaBeta);
+FOC_PWMCounter_t FOC_SVPWM_MinMax_Q15(FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_Q15_t *I_AlphaBeta);
+void FOC_SVPWM_SetOvermodulation(FOC_SVPWM_t *pwm, uint8_t mode);
+uint8_t FOC_SVPWM_GetOvermodulation(const FOC_SVPWM_t *pwm);
+FOC_Q15_t FOC_SVPWM_GetVoltageLimit_Q15(const FOC_SVPWM_t *pwm);
+FOC_Alpha_Beta_Q15_t FOC_SVPWM_Overmodulate_Q15(const FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_Q15_t *I_AlphaBeta);
+FOC_PWMCounter_t FOC_SVPWM_Modulate(FOC_SVPWM_t *pwm, FOC_Alpha_Beta_t *I_AlphaBeta);
+void FOC_SVPWM_SetDiscontinuous(FOC_SVPWM_t *pwm, uint8_t mode);
+uint8_t FOC_SVPWM_GetDiscontinuous(const FOC_SVPWM_t *pwm);
+void FOC_SVPWM_Discontinuous(const FOC_SVPWM_t *pwm, FOC_PWMCounter_t *c_PWMCounter);
+void FOC_SVPWM_DeadTimeCompensate(const FOC_SVPWM_t *pwm, FOC_PWMCounter_t *c_PWMCounter, const FOC_U_V_W_Q15_t *i_uvw);
+FOC_PWMCounter_t FOC_SVPWM_Modulate_Q15(FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_Q15_t *I_AlphaBeta);
+
+void FOC_PI_Init(FOC_PI_Q15_t *pi, float kp, float ki, FOC_Q15_t out_max);
+void FOC_PI_Reset(FOC_PI_Q15_t *pi);
+void FOC_PI_Preset(FOC_PI_Q15_t *pi, FOC_Q15_t out);
+FOC_Q15_t FOC_PI_Update_Q15(FOC_PI_Q15_t *pi, FOC_Q15_t error);
+void FOC_CurrentLoop_Init(FOC_CurrentLoop_t *loop, FOC_SVPWM_t *pwm, float kp, float ki);
+const FOC_PWMCounter_t *FOC_CurrentLoop_Update(FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw, FOC_Angle_t ElectricalAngle);
+const FOC_PWMCounter_t *FOC_CurrentLoop_VoltageUpdate(FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw, FOC_Angle_t ElectricalAngle);
 
-extern TIM_HandleTypeDef htim1;
 void FOC_ClarkePark_Debug(void);
 void FOC_InverseParkInverseClarke_Debug(void);
-void FOC_SVPWM_Debug(void);
+void FOC_SVPWM_Debug(FOC_SVPWM_t *pwm);
 
 
 #endif
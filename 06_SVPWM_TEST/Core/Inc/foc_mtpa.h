@@ -0,0 +1,15 @@
+#ifndef __FOC_MTPA_H__
+#define __FOC_MTPA_H__
+#include "foc_motor_control.h"
+#include "foc_mtpa_config.h"
+
+/**转矩给定 -> dq电流给定（最大转矩电流比）
+ * 转矩以折算q轴电流表示（Q15，基值FOC_Q15_BASE）：T = 1.5 * p * ψ * i_t，速度环输出可直接作为转矩给定；
+ * id由MTPA表插值，iq = i_t * ψ / (ψ + (Ld - Lq) * id) 由磁链倒数表插值，不需要除法与开方；
+ * 两张表由Tools/foc_mtpa_gen.c按foc_mtpa_config.h离线生成，放在flash中
+ */
+void FOC_MTPA_Init(void);
+FOC_Q15_t FOC_MTPA_Iq(FOC_Q15_t torque, FOC_Q15_t id);
+void FOC_MTPA_Reference(FOC_Q15_t torque, FOC_D_Q_Q15_t *i_ref);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef __FOC_MTPA_CONFIG_H__
+#define __FOC_MTPA_CONFIG_H__
+#include "stdint.h"
+#include "foc_ramfunc.h"
+
+/**MTPA查表配置，固件与主机端生成工具Tools/foc_mtpa_gen.c共用
+ * 只依赖stdint.h与foc_ramfunc.h，参数全部为整数，生成的foc_mtpa_table.c用#if逐项核对，参数改动后未重新生成时编译报错
+ * 重新生成（在06_SVPWM_TEST目录下；Keil工程中已填好同样的编译前步骤，默认关闭，
+ * 需要时在Options -> User -> Before Build中勾选，生成失败时停止编译）：
+ *   gcc -ICore/Inc Tools/foc_mtpa_gen.c -lm -o foc_mtpa_gen && ./foc_mtpa_gen Core/Src/foc_mtpa_table.c
+ */
+#ifndef FOC_MTPA_LD_UH
+#define FOC_MTPA_LD_UH          (800)       /*d轴电感（μH）*/
+#endif
+#ifndef FOC_MTPA_LQ_UH
+#define FOC_MTPA_LQ_UH          (1000)      /*q轴电感（μH），Lq <= Ld时MTPA即id = 0*/
+#endif
+#ifndef FOC_MTPA_FLUX_UWB
+#define FOC_MTPA_FLUX_UWB       (10000)     /*永磁体磁链（μWb）*/
+#endif
+#ifndef FOC_MTPA_I_MAX_MA
+#define FOC_MTPA_I_MAX_MA       (3000)      /*电流圆半径（mA），查表范围*/
+#endif
+
+/**表长与精度：flash占用 = 2 * (2^TABLE_BITS + 1) * sizeof(FOC_MTPA_Entry_t)
+ * TABLE_BITS：分段数2^TABLE_BITS，插值误差随分段数平方下降
+ * FRAC_BITS：表项在Q15之外多保留的小数位，0时表项为16位，否则为32位（最多16位）
+ */
+#ifndef FOC_MTPA_TABLE_BITS
+#define FOC_MTPA_TABLE_BITS     (5)
+#endif
+#ifndef FOC_MTPA_FRAC_BITS
+#define FOC_MTPA_FRAC_BITS      (0)
+#endif
+#define FOC_MTPA_TABLE_SIZE     (1u << FOC_MTPA_TABLE_BITS)
+
+#if FOC_MTPA_TABLE_BITS < 2 || FOC_MTPA_TABLE_BITS > 10 || FOC_MTPA_FRAC_BITS < 0 || FOC_MTPA_FRAC_BITS > 16
+#error "FOC_MTPA_TABLE_BITS must be 2..10 and FOC_MTPA_FRAC_BITS 0..16"
+#endif
+
+#if FOC_MTPA_FRAC_BITS == 0
+typedef int16_t FOC_MTPA_Entry_t;
+#else
+typedef int32_t FOC_MTPA_Entry_t;
+#endif
+
+/*生成的表，定义在foc_mtpa_table.c*/
+extern const float FOC_MTPA_TorqueMax;      /*电流圆上MTPA点的转矩（折算q轴电流，A）*/
+extern const FOC_MTPA_Entry_t FOC_MTPA_IdTable[FOC_MTPA_TABLE_SIZE + 1];
+extern const FOC_MTPA_Entry_t FOC_MTPA_FluxTable[FOC_MTPA_TABLE_SIZE + 1];
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef __FOC_OBSERVER_H__
+#define __FOC_OBSERVER_H__
+#include "foc_motor_control.h"
+
+/**无感观测器：滑模观测器（SMO）+ 锁相环（PLL）
+ * 输入alpha beta电流与上一周期施加的电压（Q15，基值FOC_Q15_BASE），
+ * 输出整数电角度与每个控制周期的角度增量，全部为整数运算
+ */
+#define FOC_OBSERVER_RS             (0.5f)      /*相电阻（Ω）*/
+#define FOC_OBSERVER_LS             (0.001f)    /*相电感（H），凸极电机取Lq*/
+#define FOC_OBSERVER_TS             (2.0f * 1799.0f / 72000000.0f)  /*控制周期（s），TIM1中心对齐一个PWM周期*/
+#define FOC_OBSERVER_K_SLIDE        (6.0f)      /*滑模增益（V），须大于最大反电势*/
+#define FOC_OBSERVER_BOUNDARY       (0.5f)      /*饱和函数边界层（A）*/
+#define FOC_OBSERVER_LPF_CUTOFF     (2000.0f)   /*反电势低通滤波截止频率（rad/s）*/
+#define FOC_OBSERVER_PLL_BW         (300.0f)    /*锁相环自然频率（rad/s）*/
+#define FOC_OBSERVER_PLL_DAMPING    (0.8f)      /*锁相环阻尼比*/
+#define FOC_OBSERVER_EMF_MIN        (0.2f)      /*反电势归一化下限（V），低速时限制PLL增益*/
+#define FOC_OBSERVER_CYCLE_BUDGET   (400u)      /*单次更新周期预算（CPU周期，20kHz下占1%）*/
+
+typedef struct
+{
+    /* 由FOC_Observer_Init根据电机参数计算 */
+    int32_t f;                      /*1 - Rs*Ts/Ls，Q15*/
+    int32_t g;                      /*Ts/Ls，Q15*/
+    int32_t k_slide;                /*滑模增益，Q15*/
+    int32_t k_slope;                /*边界层内斜率 K/φ，Q8*/
+    int32_t lpf;                    /*低通系数 ωc*Ts，Q15*/
+    int32_t pll_kp;                 /*PLL比例增益（角度累加器单位/Q15误差）*/
+    int32_t pll_ki;                 /*PLL积分增益，Q8*/
+    int32_t lag_k;                  /*滤波相位滞后补偿系数，Q8*/
+    int32_t emf_min;                /*Q15*/
+    /* 状态 */
+    FOC_Alpha_Beta_Q15_t i_est;     /*电流估计*/
+    FOC_Alpha_Beta_Q15_t z;         /*滑模控制量*/
+    int32_t emf_alpha;              /*滤波后反电势，Q15左移16位*/
+    int32_t emf_beta;
+    uint32_t theta;                 /*PLL角度累加器，2^32对应2π*/
+    int32_t speed;                  /*每个控制周期的角度增量，2^32对应2π*/
+    FOC_Angle_t angle;              /*补偿滤波滞后后的电角度*/
+} FOC_Observer_t;
+
+void FOC_Observer_Init(FOC_Observer_t *obs, float rs, float ls, float ts);
+void FOC_Observer_Reset(FOC_Observer_t *obs);
+FOC_Angle_t FOC_Observer_Update(FOC_Observer_t *obs, const FOC_Alpha_Beta_Q15_t *i_AlphaBeta, const FOC_Alpha_Beta_Q15_t *v_AlphaBeta);
+float FOC_Observer_GetSpeed(const FOC_Observer_t *obs, float ts);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef __FOC_PROFILE_H__
+#define __FOC_PROFILE_H__
+#include "stdint.h"
+#include "foc_ramfunc.h"
+
+/* 分阶段耗时统计：1 开启  0 关闭（各统计点展开为空，无任何开销） */
+#ifndef FOC_PROFILE_ENABLE
+#define FOC_PROFILE_ENABLE  0
+#endif
+
+/**计时源
+ * 目标板：DWT->CYCCNT，单位为CPU周期
+ * 主机仿真（定义FOC_HOST_BUILD）：CLOCK_MONOTONIC，单位为ns
+ * 以目标板CPU周期给出的耗时上限经FOC_PROFILE_FROM_CYCLES换算为计时源单位后再比较，
+ * 主机上为目标板执行同样周期数所需的时间
+ */
+#define FOC_PROFILE_CPU_MHZ (72u)           /*目标板CPU主频（MHz）*/
+
+#ifdef FOC_HOST_BUILD
+#include <time.h>
+#define FOC_PROFILE_UNIT    "ns"
+#define FOC_PROFILE_FROM_CYCLES(cycles)     ((uint32_t)((cycles) * 1000u / FOC_PROFILE_CPU_MHZ))
+static inline uint32_t FOC_Profile_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#else
+#include "main.h"
+#define FOC_PROFILE_UNIT    "cycles"
+#define FOC_PROFILE_FROM_CYCLES(cycles)     ((uint32_t)(cycles))
+static inline uint32_t FOC_Profile_Now(void)
+{
+    return DWT->CYCCNT;
+}
+#endif
+
+/*统计阶段*/
+typedef enum
+{
+    FOC_PROFILE_CLARKE_PARK = 0,    /*Clarke + Park变换*/
+    FOC_PROFILE_PI,                 /*d q轴PI*/
+    FOC_PROFILE_INV_PARK,           /*Park逆变换*/
+    FOC_PROFILE_SECTOR,             /*扇区判断*/
+    FOC_PROFILE_VECTOR_TIME,        /*矢量作用时间*/
+    FOC_PROFILE_PWM_COUNTER,        /*比较值计算*/
+    FOC_PROFILE_MINMAX,             /*最大最小值零序注入调制*/
+    FOC_PROFILE_OVERMOD,            /*过调制*/
+    FOC_PROFILE_DPWM,               /*不连续调制*/
+    FOC_PROFILE_DTC,                /*死区补偿*/
+    FOC_PROFILE_COMPARE_WRITE,      /*比较寄存器写入*/
+    FOC_PROFILE_DEBUG,              /*debug格式化输出*/
+    FOC_PROFILE_OBSERVER,           /*无感观测器*/
+    FOC_PROFILE_VBUS,               /*母线电压滤波与前馈更新*/
+    FOC_PROFILE_ENCODER,            /*编码器测速与角度插值*/
+    FOC_PROFILE_HALL_EDGE,          /*霍尔边沿中断*/
+    FOC_PROFILE_FIELDWEAK,          /*弱磁*/
+    FOC_PROFILE_MTPA,               /*MTPA查表*/
+    FOC_PROFILE_CONTROL_ISR,        /*电流环中断整体*/
+    FOC_PROFILE_STAGE_NUM
+} FOC_ProfileStage_t;
+
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint32_t count;
+    uint64_t total;
+} FOC_ProfileStat_t;
+
+#if FOC_PROFILE_ENABLE
+#define FOC_PROFILE_START(stage)    uint32_t foc_profile_##stage = FOC_Profile_Now()
+#define FOC_PROFILE_STOP(stage)     FOC_Profile_Record(stage, FOC_Profile_Now() - foc_profile_##stage)
+#else
+#define FOC_PROFILE_START(stage)
+#define FOC_PROFILE_STOP(stage)
+#endif
+
+void FOC_Profile_Init(void);
+void FOC_Profile_Reset(void);
+void FOC_Profile_Record(FOC_ProfileStage_t stage, uint32_t elapsed);
+const FOC_ProfileStat_t *FOC_Profile_Get(FOC_ProfileStage_t stage);
+void FOC_Profile_Report(void);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __FOC_RAMFUNC_H__
+#define __FOC_RAMFUNC_H__
+
+/**电流环中断链在SRAM中执行：1 开启  0 全部留在flash（默认）
+ * 72MHz下flash为2个等待周期，预取缓冲只能掩盖顺序取指，跳转与查表仍要等待；SRAM为0等待
+ * FOC_RAMFUNC标记的函数放在.ramfunc段，FOC_RAMDATA标记的常量表放在.ramdata段，
+ * 由分散加载文件MDK-ARM/06_SVPWM_TEST.sct放到SRAM执行区ER_RAMFUNC，
+ * 启动文件Reset_Handler跳转的__main在进入main()之前把它们从flash复制到SRAM；
+ * SRAM中的代码与数据同在系统总线上，取指与读数据会相互等待，实际收益以FOC_Benchmark_CurrentLoop的输出为准；
+ * 目前还没有目标板上的对比数据，默认留在flash，不占用SRAM：在开发板上分别以0、1编译运行
+ * FOC_Benchmark_CurrentLoop，SRAM执行的平均与最大周期数确有明显减少时再改为1，并把两组数据记在这里
+ * 分散加载文件经预处理后读取本文件中的这个开关，修改默认值而不要在编译选项中定义，保证两者一致
+ * 只对ARM编译器生效，主机仿真与生成工具展开为空
+ */
+#ifndef FOC_RAM_EXEC
+#define FOC_RAM_EXEC        0
+#endif
+
+#if FOC_RAM_EXEC && (defined(__CC_ARM) || defined(__ARMCC_VERSION))
+#define FOC_RAMFUNC         __attribute__((section(".ramfunc")))
+#define FOC_RAMDATA         __attribute__((section(".ramdata")))
+#define FOC_RAM_EXEC_NAME   "ram"
+#else
+#define FOC_RAMFUNC
+#define FOC_RAMDATA
+#define FOC_RAM_EXEC_NAME   "flash"
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __FOC_SIN_CONFIG_H__
+#define __FOC_SIN_CONFIG_H__
+#include "stdint.h"
+#include "foc_ramfunc.h"
+
+/**正弦查表配置，固件与主机端生成工具Tools/foc_sin_gen.c共用
+ * FOC_SinCos（浮点）与FOC_SinCos_Q15（定点）共用同一张表，表项格式不同时在查表时换算；
+ * 生成的foc_sin_table.c用#if核对配置，配置改动后未重新生成时编译报错
+ * 重新生成（在06_SVPWM_TEST目录下；Keil工程中已填好同样的编译前步骤，默认关闭，
+ * 需要时在Options -> User -> Before Build中勾选，生成失败时停止编译）：
+ *   gcc -ICore/Inc Tools/foc_sin_gen.c -lm -o foc_sin_gen && ./foc_sin_gen Core/Src/foc_sin_table.c
+ * 生成时在终端输出该配置下表本身的插值最大误差、均方根误差与flash占用，
+ * 主机仿真（Simulation/sim_main.c）输出FOC_SinCos、FOC_SinCos_Q15实际的误差与耗时
+ */
+
+/*表项格式*/
+#define FOC_SIN_FORMAT_Q15          0           /*int16_t，32767对应1.0*/
+#define FOC_SIN_FORMAT_Q31          1           /*int32_t，2147483647对应1.0，定点查表在Q23下插值*/
+#define FOC_SIN_FORMAT_FLOAT        2           /*float，没有FPU时定点查表需要逐项换算，最慢*/
+
+/*对称性*/
+#define FOC_SIN_SYMMETRY_QUARTER    0           /*0~π/2，其余象限由对称性折叠，表最小*/
+#define FOC_SIN_SYMMETRY_FULL       1           /*0~2π，不需要象限折叠，同点数下表为4倍*/
+
+#ifndef FOC_SIN_FORMAT
+#define FOC_SIN_FORMAT              FOC_SIN_FORMAT_Q15
+#endif
+#ifndef FOC_SIN_SYMMETRY
+#define FOC_SIN_SYMMETRY            FOC_SIN_SYMMETRY_QUARTER
+#endif
+/**表长：表中等分点数2^TABLE_BITS（另加1项供末段插值），插值误差约为(段长)² / 8
+ * 1/4周期表4~12，整周期表6~14；下限保证定点插值的中间结果不超出int32
+ */
+#ifndef FOC_SIN_TABLE_BITS
+#define FOC_SIN_TABLE_BITS          (7)
+#endif
+#define FOC_SIN_TABLE_SIZE          (1u << FOC_SIN_TABLE_BITS)
+
+#if FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER
+#define FOC_SIN_TABLE_ANGLE_BITS    (FOC_SIN_TABLE_BITS + 2)    /*整周期对应的表索引位数（含象限）*/
+#if FOC_SIN_TABLE_BITS < 4 || FOC_SIN_TABLE_BITS > 12
+#error "FOC_SIN_TABLE_BITS must be 4..12 for a quarter-wave table"
+#endif
+#elif FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_FULL
+#define FOC_SIN_TABLE_ANGLE_BITS    (FOC_SIN_TABLE_BITS)
+#if FOC_SIN_TABLE_BITS < 6 || FOC_SIN_TABLE_BITS > 14
+#error "FOC_SIN_TABLE_BITS must be 6..14 for a full-wave table"
+#endif
+#else
+#error "unknown FOC_SIN_SYMMETRY"
+#endif
+
+#if FOC_SIN_FORMAT == FOC_SIN_FORMAT_Q15
+typedef int16_t FOC_SinEntry_t;
+#elif FOC_SIN_FORMAT == FOC_SIN_FORMAT_Q31
+typedef int32_t FOC_SinEntry_t;
+#elif FOC_SIN_FORMAT == FOC_SIN_FORMAT_FLOAT
+typedef float FOC_SinEntry_t;
+#else
+#error "unknown FOC_SIN_FORMAT"
+#endif
+
+/*生成的表，定义在foc_sin_table.c*/
+extern const FOC_SinEntry_t FOC_SinTable[FOC_SIN_TABLE_SIZE + 1];
+
+#endif
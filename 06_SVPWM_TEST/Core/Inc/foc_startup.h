@@ -0,0 +1,70 @@
+#ifndef __FOC_STARTUP_H__
+#define __FOC_STARTUP_H__
+#include "foc_motor_control.h"
+#include "foc_cascade.h"
+
+/**开环启动：定位 -> I/f加速 -> 等待位置估计锁定 -> 切换到闭环角度与速度环
+ * 1. 定位：d轴通直流把转子拉到电角度0
+ * 2. I/f加速：电流矢量幅值恒定，角度按加速曲线开环累加；转子在负载角处自动跟随，
+ *    加速曲线在FOC_Startup_Init中预先算成每段的角度增量表，中断中只做一次加法
+ * 3. 锁定：保持末速度，角度误差 e = θ估计 - θ开环 在连续几个窗口内基本不变时认为观测器（或编码器）已锁定
+ * 4. 切换：输出角度取 θ估计 - e，e每个PWM周期按自身大小的一定比例衰减（误差大时修正快，接近0时平滑收尾），
+ *    同时iq给定按 T0 / cos(e) 变化（T0 = I * cos(e0)），转子上的转矩在切换过程中保持不变；
+ *    e衰减到门限以内后速度环接管，积分预置为当前iq，速度给定为I/f末速度
+ */
+#define FOC_STARTUP_ALIGN_CURRENT   (1.5f)      /*定位电流（A）*/
+#define FOC_STARTUP_ALIGN_TIME      (0.3f)      /*定位时间（s）*/
+#define FOC_STARTUP_CURRENT         (2.0f)      /*I/f电流（A），须能克服负载、摩擦与加速转矩*/
+#define FOC_STARTUP_SPEED           (300.0f)    /*I/f末速度（电角速度 rad/s），须高于观测器可用的最低转速*/
+#define FOC_STARTUP_RAMP_TIME       (0.5f)      /*加速时间（s）*/
+#ifndef FOC_STARTUP_PROFILE
+#define FOC_STARTUP_PROFILE         FOC_STARTUP_PROFILE_SCURVE   /*加速曲线，见下方FOC_STARTUP_PROFILE_xxx*/
+#endif
+#define FOC_STARTUP_PROFILE_POINTS  (64u)       /*加速曲线分段数，每段内角度增量不变*/
+#define FOC_STARTUP_LOCK_WINDOW     (0.01f)     /*锁定检查窗口（s）*/
+#define FOC_STARTUP_LOCK_DRIFT      (5.0f)      /*一个窗口内角度误差变化上限（电角度，°）*/
+#define FOC_STARTUP_LOCK_COUNT      (5u)        /*连续满足条件的窗口数*/
+#define FOC_STARTUP_ERROR_MAX       (85.0f)     /*允许切换的最大角度误差（电角度，°），超过90°时I/f转矩方向已不可信*/
+#define FOC_STARTUP_TIMEOUT         (1.0f)      /*加速结束后等待锁定的最长时间（s），超时进入故障状态*/
+#define FOC_STARTUP_HANDOVER_SHIFT  (8u)        /*切换时每个PWM周期误差衰减 e / 2^SHIFT*/
+#define FOC_STARTUP_HANDOVER_DONE   (2.0f)      /*误差小于该值时切换完成（电角度，°）*/
+
+/*加速曲线*/
+#define FOC_STARTUP_PROFILE_LINEAR  0           /*匀加速*/
+#define FOC_STARTUP_PROFILE_SCURVE  1           /*摆线S曲线，起止处加速度为0，峰值加速度为匀加速的2倍*/
+
+/*启动状态*/
+#define FOC_STARTUP_IDLE        0
+#define FOC_STARTUP_ALIGN       1
+#define FOC_STARTUP_RAMP        2
+#define FOC_STARTUP_LOCK        3
+#define FOC_STARTUP_HANDOVER    4
+#define FOC_STARTUP_DONE        5
+#define FOC_STARTUP_FAULT       6               /*加速结束后位置估计未能锁定（失步、电流不足或观测器参数问题）*/
+
+typedef struct
+{
+    volatile uint8_t state;
+    uint8_t lock_count;             /*连续满足锁定条件的窗口数*/
+    uint16_t segment;               /*当前加速曲线分段*/
+    uint32_t count;                 /*当前步骤（加速时为分段，锁定时为窗口）已执行的PWM周期数*/
+    uint32_t n_align, n_segment, n_window, n_timeout;
+    FOC_Q15_t align_current;
+    FOC_Q15_t current;              /*I/f电流*/
+    FOC_Q15_t torque;               /*切换开始时的转矩电流 I * cos(e0)*/
+    FOC_Q15_t speed_ref;            /*切换完成后的速度给定（Q15，基值FOC_SPEED_BASE）*/
+    uint32_t step[FOC_STARTUP_PROFILE_POINTS + 1];  /*每段每个PWM周期的角度增量（取分段中点速度），最后一项为末速度，2^32对应2π*/
+    uint32_t theta;                 /*开环角度累加器，2^32对应2π*/
+    FOC_AngleDiff_t error;          /*θ估计 - θ开环，切换时为剩余误差*/
+    FOC_AngleDiff_t error_mark;     /*锁定窗口起点的误差*/
+    FOC_AngleDiff_t lock_drift, error_max, done_error;
+    uint32_t wait;                  /*加速结束后等待锁定的PWM周期数*/
+} FOC_Startup_t;
+
+void FOC_Startup_Init(FOC_Startup_t *st, float ts);
+void FOC_Startup_Start(FOC_Startup_t *st);
+uint8_t FOC_Startup_Busy(const FOC_Startup_t *st);
+FOC_Angle_t FOC_Startup_Update(FOC_Startup_t *st, FOC_CurrentLoop_t *loop, FOC_Angle_t est_angle);
+void FOC_Startup_Apply(const FOC_Startup_t *st, const FOC_CurrentLoop_t *loop, FOC_Cascade_t *cascade);
+
+#endif
@@ -59,11 +59,16 @@ void EXTI0_IRQHandler(void);
 void EXTI2_IRQHandler(void);
 void EXTI3_IRQHandler(void);
 void EXTI4_IRQHandler(void);
+void DMA1_Channel1_IRQHandler(void);
 void DMA1_Channel4_IRQHandler(void);
 void DMA1_Channel5_IRQHandler(void);
+void ADC1_2_IRQHandler(void);
 void TIM1_BRK_IRQHandler(void);
+void TIM2_IRQHandler(void);
 void USART1_IRQHandler(void);
+void ADC3_IRQHandler(void);
 void TIM6_IRQHandler(void);
+void DMA2_Channel4_5_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
@@ -0,0 +1,597 @@
+#include "foc_benchmark.h"
+#include "stdlib.h"
+#include "arm_math.h"
+
+/********************************************************************************
+ * DWT周期计数器初始化（72MHz下1个计数 = 1个CPU周期）
+ *********************************************************************************/
+static void Benchmark_CycleCounterInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* 原arm_sin/arm_cos实现（512点整周期表），仅作为FOC_SinCos的基准对照 */
+static const float sinTable[512 + 1] =
+    {
+    0.00000000f, 0.01227154f, 0.02454123f, 0.03680722f, 0.04906767f, 0.06132074f,
+    0.07356456f, 0.08579731f, 0.09801714f, 0.11022221f, 0.12241068f, 0.13458071f,
+    0.14673047f, 0.15885814f, 0.17096189f, 0.18303989f, 0.19509032f, 0.20711138f,
+    0.21910124f, 0.23105811f, 0.24298018f, 0.25486566f, 0.26671276f, 0.27851969f,
+    0.29028468f, 0.30200595f, 0.31368174f, 0.32531029f, 0.33688985f, 0.34841868f,
+    0.35989504f, 0.37131719f, 0.38268343f, 0.39399204f, 0.40524131f, 0.41642956f,
+    0.42755509f, 0.43861624f, 0.44961133f, 0.46053871f, 0.47139674f, 0.48218377f,
+    0.49289819f, 0.50353838f, 0.51410274f, 0.52458968f, 0.53499762f, 0.54532499f,
+    0.55557023f, 0.56573181f, 0.57580819f, 0.58579786f, 0.59569930f, 0.60551104f,
+    0.61523159f, 0.62485949f, 0.63439328f, 0.64383154f, 0.65317284f, 0.66241578f,
+    0.67155895f, 0.68060100f, 0.68954054f, 0.69837625f, 0.70710678f, 0.71573083f,
+    0.72424708f, 0.73265427f, 0.74095113f, 0.74913639f, 0.75720885f, 0.76516727f,
+    0.77301045f, 0.78073723f, 0.78834643f, 0.79583690f, 0.80320753f, 0.81045720f,
+    0.81758481f, 0.82458930f, 0.83146961f, 0.83822471f, 0.84485357f, 0.85135519f,
+    0.85772861f, 0.86397286f, 0.87008699f, 0.87607009f, 0.88192126f, 0.88763962f,
+    0.89322430f, 0.89867447f, 0.90398929f, 0.90916798f, 0.91420976f, 0.91911385f,
+    0.92387953f, 0.92850608f, 0.93299280f, 0.93733901f, 0.94154407f, 0.94560733f,
+    0.94952818f, 0.95330604f, 0.95694034f, 0.96043052f, 0.96377607f, 0.96697647f,
+    0.97003125f, 0.97293995f, 0.97570213f, 0.97831737f, 0.98078528f, 0.98310549f,
+    0.98527764f, 0.98730142f, 0.98917651f, 0.99090264f, 0.99247953f, 0.99390697f,
+    0.99518473f, 0.99631261f, 0.99729046f, 0.99811811f, 0.99879546f, 0.99932238f,
+    0.99969882f, 0.99992470f, 1.00000000f, 0.99992470f, 0.99969882f, 0.99932238f,
+    0.99879546f, 0.99811811f, 0.99729046f, 0.99631261f, 0.99518473f, 0.99390697f,
+    0.99247953f, 0.99090264f, 0.98917651f, 0.98730142f, 0.98527764f, 0.98310549f,
+    0.98078528f, 0.97831737f, 0.97570213f, 0.97293995f, 0.97003125f, 0.96697647f,
+    0.96377607f, 0.96043052f, 0.95694034f, 0.95330604f, 0.94952818f, 0.94560733f,
+    0.94154407f, 0.93733901f, 0.93299280f, 0.92850608f, 0.92387953f, 0.91911385f,
+    0.91420976f, 0.90916798f, 0.90398929f, 0.89867447f, 0.89322430f, 0.88763962f,
+    0.88192126f, 0.87607009f, 0.87008699f, 0.86397286f, 0.85772861f, 0.85135519f,
+    0.84485357f, 0.83822471f, 0.83146961f, 0.82458930f, 0.81758481f, 0.81045720f,
+    0.80320753f, 0.79583690f, 0.78834643f, 0.78073723f, 0.77301045f, 0.76516727f,
+    0.75720885f, 0.74913639f, 0.74095113f, 0.73265427f, 0.72424708f, 0.71573083f,
+    0.70710678f, 0.69837625f, 0.68954054f, 0.68060100f, 0.67155895f, 0.66241578f,
+    0.65317284f, 0.64383154f, 0.63439328f, 0.62485949f, 0.61523159f, 0.60551104f,
+    0.59569930f, 0.58579786f, 0.57580819f, 0.56573181f, 0.55557023f, 0.54532499f,
+    0.53499762f, 0.52458968f, 0.51410274f, 0.50353838f, 0.49289819f, 0.48218377f,
+    0.47139674f, 0.46053871f, 0.44961133f, 0.43861624f, 0.42755509f, 0.41642956f,
+    0.40524131f, 0.39399204f, 0.38268343f, 0.37131719f, 0.35989504f, 0.34841868f,
+    0.33688985f, 0.32531029f, 0.31368174f, 0.30200595f, 0.29028468f, 0.27851969f,
+    0.26671276f, 0.25486566f, 0.24298018f, 0.23105811f, 0.21910124f, 0.20711138f,
+    0.19509032f, 0.18303989f, 0.17096189f, 0.15885814f, 0.14673047f, 0.13458071f,
+    0.12241068f, 0.11022221f, 0.09801714f, 0.08579731f, 0.07356456f, 0.06132074f,
+    0.04906767f, 0.03680722f, 0.02454123f, 0.01227154f, 0.00000000f, -0.01227154f,
+    -0.02454123f, -0.03680722f, -0.04906767f, -0.06132074f, -0.07356456f,
+    -0.08579731f, -0.09801714f, -0.11022221f, -0.12241068f, -0.13458071f,
+    -0.14673047f, -0.15885814f, -0.17096189f, -0.18303989f, -0.19509032f,
+    -0.20711138f, -0.21910124f, -0.23105811f, -0.24298018f, -0.25486566f,
+    -0.26671276f, -0.27851969f, -0.29028468f, -0.30200595f, -0.31368174f,
+    -0.32531029f, -0.33688985f, -0.34841868f, -0.35989504f, -0.37131719f,
+    -0.38268343f, -0.39399204f, -0.40524131f, -0.41642956f, -0.42755509f,
+    -0.43861624f, -0.44961133f, -0.46053871f, -0.47139674f, -0.48218377f,
+    -0.49289819f, -0.50353838f, -0.51410274f, -0.52458968f, -0.53499762f,
+    -0.54532499f, -0.55557023f, -0.56573181f, -0.57580819f, -0.58579786f,
+    -0.59569930f, -0.60551104f, -0.61523159f, -0.62485949f, -0.63439328f,
+    -0.64383154f, -0.65317284f, -0.66241578f, -0.67155895f, -0.68060100f,
+    -0.68954054f, -0.69837625f, -0.70710678f, -0.71573083f, -0.72424708f,
+    -0.73265427f, -0.74095113f, -0.74913639f, -0.75720885f, -0.76516727f,
+    -0.77301045f, -0.78073723f, -0.78834643f, -0.79583690f, -0.80320753f,
+    -0.81045720f, -0.81758481f, -0.82458930f, -0.83146961f, -0.83822471f,
+    -0.84485357f, -0.85135519f, -0.85772861f, -0.86397286f, -0.87008699f,
+    -0.87607009f, -0.88192126f, -0.88763962f, -0.89322430f, -0.89867447f,
+    -0.90398929f, -0.90916798f, -0.91420976f, -0.91911385f, -0.92387953f,
+    -0.92850608f, -0.93299280f, -0.93733901f, -0.94154407f, -0.94560733f,
+    -0.94952818f, -0.95330604f, -0.95694034f, -0.96043052f, -0.96377607f,
+    -0.96697647f, -0.97003125f, -0.97293995f, -0.97570213f, -0.97831737f,
+    -0.98078528f, -0.98310549f, -0.98527764f, -0.98730142f, -0.98917651f,
+    -0.99090264f, -0.99247953f, -0.99390697f, -0.99518473f, -0.99631261f,
+    -0.99729046f, -0.99811811f, -0.99879546f, -0.99932238f, -0.99969882f,
+    -0.99992470f, -1.00000000f, -0.99992470f, -0.99969882f, -0.99932238f,
+    -0.99879546f, -0.99811811f, -0.99729046f, -0.99631261f, -0.99518473f,
+    -0.99390697f, -0.99247953f, -0.99090264f, -0.98917651f, -0.98730142f,
+    -0.98527764f, -0.98310549f, -0.98078528f, -0.97831737f, -0.97570213f,
+    -0.97293995f, -0.97003125f, -0.96697647f, -0.96377607f, -0.96043052f,
+    -0.95694034f, -0.95330604f, -0.94952818f, -0.94560733f, -0.94154407f,
+    -0.93733901f, -0.93299280f, -0.92850608f, -0.92387953f, -0.91911385f,
+    -0.91420976f, -0.90916798f, -0.90398929f, -0.89867447f, -0.89322430f,
+    -0.88763962f, -0.88192126f, -0.87607009f, -0.87008699f, -0.86397286f,
+    -0.85772861f, -0.85135519f, -0.84485357f, -0.83822471f, -0.83146961f,
+    -0.82458930f, -0.81758481f, -0.81045720f, -0.80320753f, -0.79583690f,
+    -0.78834643f, -0.78073723f, -0.77301045f, -0.76516727f, -0.75720885f,
+    -0.74913639f, -0.74095113f, -0.73265427f, -0.72424708f, -0.71573083f,
+    -0.70710678f, -0.69837625f, -0.68954054f, -0.68060100f, -0.67155895f,
+    -0.66241578f, -0.65317284f, -0.64383154f, -0.63439328f, -0.62485949f,
+    -0.61523159f, -0.60551104f, -0.59569930f, -0.58579786f, -0.57580819f,
+    -0.56573181f, -0.55557023f, -0.54532499f, -0.53499762f, -0.52458968f,
+    -0.51410274f, -0.50353838f, -0.49289819f, -0.48218377f, -0.47139674f,
+    -0.46053871f, -0.44961133f, -0.43861624f, -0.42755509f, -0.41642956f,
+    -0.40524131f, -0.39399204f, -0.38268343f, -0.37131719f, -0.35989504f,
+    -0.34841868f, -0.33688985f, -0.32531029f, -0.31368174f, -0.30200595f,
+    -0.29028468f, -0.27851969f, -0.26671276f, -0.25486566f, -0.24298018f,
+    -0.23105811f, -0.21910124f, -0.20711138f, -0.19509032f, -0.18303989f,
+    -0.17096189f, -0.15885814f, -0.14673047f, -0.13458071f, -0.12241068f,
+    -0.11022221f, -0.09801714f, -0.08579731f, -0.07356456f, -0.06132074f,
+    -0.04906767f, -0.03680722f, -0.02454123f, -0.01227154f, -0.00000000f,
+};
+
+static float arm_cos(float x)
+{
+    float cosVal, fract, in; /* Temporary input, output variables */
+    uint16_t index;          /* Index variable */
+    float a, b;              /* Two nearest output values */
+    int32_t n;
+    float findex;
+
+    /* input x is in radians */
+    /* Scale input to [0 1] range from [0 2*PI] , divide input by 2*pi, add 0.25 (pi/2) to read sine table */
+    in = x * 0.159154943092f + 0.25f;
+
+    /* Calculation of floor value of input */
+    n = (int32_t)in;
+
+    /* Make negative values towards -infinity */
+    if (in < 0.0f)
+    {
+        n--;
+    }
+
+    /* Map input value to [0 1] */
+    in = in - (float)n;
+
+    /* Calculation of index of the table */
+    findex = (float)512 * in;
+    index = (uint16_t)findex;
+
+    /* when "in" is exactly 1, we need to rotate the index down to 0 */
+    if (index >= 512)
+    {
+        index = 0;
+        findex -= (float)512;
+    }
+
+    /* fractional value calculation */
+    fract = findex - (float)index;
+
+    /* Read two nearest values of input value from the cos table */
+    a = sinTable[index];
+    b = sinTable[index + 1];
+
+    /* Linear interpolation process */
+    cosVal = (1.0f - fract) * a + fract * b;
+
+    /* Return output value */
+    return (cosVal);
+}
+
+static float arm_sin(float x)
+{
+    float sinVal, fract, in; /* Temporary input, output variables */
+    uint16_t index;          /* Index variable */
+    float a, b;              /* Two nearest output values */
+    int32_t n;
+    float findex;
+
+    /* input x is in radians */
+    /* Scale input to [0 1] range from [0 2*PI] , divide input by 2*pi */
+    in = x * 0.159154943092f;
+
+    /* Calculation of floor value of input */
+    n = (int32_t)in;
+
+    /* Make negative values towards -infinity */
+    if (in < 0.0f)
+    {
+        n--;
+    }
+
+    /* Map input value to [0 1] */
+    in = in - (float)n;
+
+    /* Calculation of index of the table */
+    findex = (float)512 * in;
+    index = (uint16_t)findex;
+
+    /* when "in" is exactly 1, we need to rotate the index down to 0 */
+    if (index >= 512)
+    {
+        index = 0;
+        findex -= (float)512;
+    }
+
+    /* fractional value calculation */
+    fract = findex - (float)index;
+
+    /* Read two nearest values of input value from the sin table */
+    a = sinTable[index];
+    b = sinTable[index + 1];
+
+    /* Linear interpolation process */
+    sinVal = (1.0f - fract) * a + fract * b;
+
+    /* Return output value */
+    return (sinVal);
+}
+
+/* debug()使用DMA发送，连续输出前等待上一帧发送完成 */
+static void Benchmark_WaitDebugIdle(void)
+{
+    while (huart1.gState != HAL_UART_STATE_READY)
+    {
+    }
+}
+
+/********************************************************************************
+ * 浮点与Q15变换链对比
+ * Clarke -> Park -> Park逆变换 -> Clarke逆变换，扫描整周电角度与多个幅值，
+ * 输出每条变换链的平均周期数以及Q15结果相对浮点结果的最大误差
+ *********************************************************************************/
+void FOC_Benchmark_Transform(void)
+{
+    uint32_t angle, start;
+    uint32_t count = 0;
+    uint32_t cycles_float = 0;
+    uint32_t cycles_q15 = 0;
+    float max_error = 0.0f;
+    float error;
+    FOC_Q15_t amplitude, sin_q15, cos_q15;
+
+    Benchmark_CycleCounterInit();
+    for (amplitude = 4096; amplitude <= 28672; amplitude += 8192)
+    {
+        for (angle = 0; angle < 65536u; angle += BENCHMARK_ANGLE_STEP)
+        {
+            FOC_U_V_W_Q15_t uvw_q15, uvw_q15_out;
+            FOC_Alpha_Beta_Q15_t alphabeta_q15;
+            FOC_D_Q_Q15_t dq_q15;
+            FOC_U_V_W_t uvw, uvw_out;
+            FOC_Alpha_Beta_t alphabeta;
+            FOC_D_Q_t dq;
+            FOC_Angle_t theta = FOC_ANGLE_FROM_U16(angle);
+
+            /* 两条链使用完全相同的输入 */
+            FOC_SinCos_Q15(theta, &sin_q15, &cos_q15);
+            uvw_q15.iu = (FOC_Q15_t)(((FOC_Q31_t)amplitude * sin_q15) >> 15);
+            FOC_SinCos_Q15((FOC_Angle_t)(theta - FOC_ANGLE_2PI_3), &sin_q15, &cos_q15);
+            uvw_q15.iv = (FOC_Q15_t)(((FOC_Q31_t)amplitude * sin_q15) >> 15);
+            uvw_q15.iw = (FOC_Q15_t)(-uvw_q15.iu - uvw_q15.iv);
+            uvw.iu = FOC_Q15_TO_FLOAT(uvw_q15.iu);
+            uvw.iv = FOC_Q15_TO_FLOAT(uvw_q15.iv);
+            uvw.iw = FOC_Q15_TO_FLOAT(uvw_q15.iw);
+
+            start = DWT->CYCCNT;
+            alphabeta = FOC_Clarke_Transform(&uvw);
+            dq = FOC_Park_Transform(&alphabeta, theta);
+            alphabeta = FOC_Inverse_Park_Transform(&dq, theta);
+            uvw_out = FOC_Inverse_Clarke_Transform(&alphabeta);
+            cycles_float += DWT->CYCCNT - start;
+
+            start = DWT->CYCCNT;
+            alphabeta_q15 = FOC_Clarke_Transform_Q15(&uvw_q15);
+            dq_q15 = FOC_Park_Transform_Q15(&alphabeta_q15, theta);
+            alphabeta_q15 = FOC_Inverse_Park_Transform_Q15(&dq_q15, theta);
+            uvw_q15_out = FOC_Inverse_Clarke_Transform_Q15(&alphabeta_q15);
+            cycles_q15 += DWT->CYCCNT - start;
+
+            error = fabsf(FOC_Q15_TO_FLOAT(dq_q15.id) - dq.id) + fabsf(FOC_Q15_TO_FLOAT(dq_q15.iq) - dq.iq);
+            error += fabsf(FOC_Q15_TO_FLOAT(uvw_q15_out.iu) - uvw_out.iu);
+            error += fabsf(FOC_Q15_TO_FLOAT(uvw_q15_out.iv) - uvw_out.iv);
+            error += fabsf(FOC_Q15_TO_FLOAT(uvw_q15_out.iw) - uvw_out.iw);
+            if (error > max_error)
+            {
+                max_error = error;
+            }
+            count++;
+        }
+    }
+
+    Benchmark_WaitDebugIdle();
+    debug("transform float:%lu cycles, q15:%lu cycles, max error:%f\r\n",
+          (unsigned long)(cycles_float / count),
+          (unsigned long)(cycles_q15 / count),
+          max_error);
+}
+
+/********************************************************************************
+ * 正余弦计算对比（每对Park/Park逆变换所需的三角函数开销）
+ * 原实现：两次变换各调用一次arm_sin与arm_cos，共4次查表
+ * 现实现：两次变换各调用一次FOC_SinCos（浮点）或FOC_SinCos_Q15（定点）
+ *********************************************************************************/
+void FOC_Benchmark_SinCos(void)
+{
+    uint32_t angle, start;
+    uint32_t count = 0;
+    uint32_t cycles_legacy = 0;
+    uint32_t cycles_fused = 0;
+    uint32_t cycles_q15 = 0;
+    float max_error = 0.0f;
+    float error;
+    volatile float sink;
+    float sin_legacy, cos_legacy, sinTheta, cosTheta;
+    FOC_Q15_t sin_q15, cos_q15;
+
+    Benchmark_CycleCounterInit();
+    for (angle = 0; angle < 65536u; angle += BENCHMARK_ANGLE_STEP)
+    {
+        float theta = (float)angle * (_2PI / 65536.0f);
+        FOC_Angle_t electrical_angle = FOC_ANGLE_FROM_U16(angle);
+
+        start = DWT->CYCCNT;
+        sin_legacy = arm_sin(theta);
+        cos_legacy = arm_cos(theta);
+        sink = sin_legacy + cos_legacy;
+        sin_legacy = arm_sin(theta);
+        cos_legacy = arm_cos(theta);
+        cycles_legacy += DWT->CYCCNT - start;
+        sink = sin_legacy + cos_legacy;
+
+        start = DWT->CYCCNT;
+        FOC_SinCos(electrical_angle, &sinTheta, &cosTheta);
+        sink = sinTheta + cosTheta;
+        FOC_SinCos(electrical_angle, &sinTheta, &cosTheta);
+        cycles_fused += DWT->CYCCNT - start;
+        sink = sinTheta + cosTheta;
+
+        start = DWT->CYCCNT;
+        FOC_SinCos_Q15(electrical_angle, &sin_q15, &cos_q15);
+        sink = sin_q15 + cos_q15;
+        FOC_SinCos_Q15(electrical_angle, &sin_q15, &cos_q15);
+        cycles_q15 += DWT->CYCCNT - start;
+        sink = sin_q15 + cos_q15;
+
+        error = fabsf(sinTheta - sin_legacy) + fabsf(cosTheta - cos_legacy);
+        error += fabsf((float)sin_q15 / 32768.0f - sin_legacy) + fabsf((float)cos_q15 / 32768.0f - cos_legacy);
+        if (error > max_error)
+        {
+            max_error = error;
+        }
+        count++;
+    }
+    (void)sink;
+
+    Benchmark_WaitDebugIdle();
+    debug("sincos per park pair legacy:%lu cycles, fused:%lu cycles, q15:%lu cycles, max error:%f\r\n",
+          (unsigned long)(cycles_legacy / count),
+          (unsigned long)(cycles_fused / count),
+          (unsigned long)(cycles_q15 / count),
+          max_error);
+}
+
+/********************************************************************************
+ * SVPWM实现对比
+ * 扇区法：FOC_SVPWM_GetSector -> FOC_SVPWM_GetVectorTime -> FOC_SVPWM_GetPWMCounter
+ * 最大最小值法：FOC_SVPWM_MinMax
+ * 扫描整周电角度与多个电压幅值（含过调制），输出两种实现的平均周期数
+ * 以及三相比较值偏差之和的最大值（计数值）；pwm须已由FOC_SVPWM_Init初始化
+ *********************************************************************************/
+void FOC_Benchmark_SVPWM(FOC_SVPWM_t *pwm)
+{
+    uint32_t angle, start;
+    uint32_t count = 0;
+    uint32_t cycles_sector = 0;
+    uint32_t cycles_minmax = 0;
+    int32_t max_error = 0;
+    int32_t error;
+    float amplitude, sinTheta, cosTheta;
+    uint8_t sector;
+    FOC_Alpha_Beta_t alphabeta;
+    FOC_VectorTime_t t_VectorTime;
+    FOC_PWMCounter_t counter_sector, counter_minmax;
+
+    Benchmark_CycleCounterInit();
+    for (amplitude = 1.0f; amplitude < 8.0f; amplitude += 1.5f)
+    {
+        for (angle = 0; angle < 65536u; angle += BENCHMARK_ANGLE_STEP)
+        {
+            FOC_SinCos(FOC_ANGLE_FROM_U16(angle), &sinTheta, &cosTheta);
+            alphabeta.alpha = amplitude * cosTheta;
+            alphabeta.beta = amplitude * sinTheta;
+
+            start = DWT->CYCCNT;
+            sector = FOC_SVPWM_GetSector(&alphabeta);
+            t_VectorTime = FOC_SVPWM_GetVectorTime(pwm, sector, &alphabeta);
+            counter_sector = FOC_SVPWM_GetPWMCounter(pwm, sector, &t_VectorTime);
+            cycles_sector += DWT->CYCCNT - start;
+
+            start = DWT->CYCCNT;
+            counter_minmax = FOC_SVPWM_MinMax(pwm, &alphabeta);
+            cycles_minmax += DWT->CYCCNT - start;
+
+            error = abs((int32_t)counter_sector.counter_0 - counter_minmax.counter_0);
+            error += abs((int32_t)counter_sector.counter_1 - counter_minmax.counter_1);
+            error += abs((int32_t)counter_sector.counter_2 - counter_minmax.counter_2);
+            if (error > max_error)
+            {
+                max_error = error;
+            }
+            count++;
+        }
+    }
+
+    Benchmark_WaitDebugIdle();
+    debug("svpwm sector:%lu cycles, minmax:%lu cycles, max compare error:%ld\r\n",
+          (unsigned long)(cycles_sector / count),
+          (unsigned long)(cycles_minmax / count),
+          (long)max_error);
+}
+
+/********************************************************************************
+ * 无感观测器耗时
+ * 以恒幅旋转的合成电流/电压驱动FOC_Observer_Update，
+ * 输出平均与最大周期数，并与FOC_OBSERVER_CYCLE_BUDGET比较
+ *********************************************************************************/
+void FOC_Benchmark_Observer(void)
+{
+    uint32_t angle, start, cycles;
+    uint32_t count = 0;
+    uint32_t cycles_total = 0;
+    uint32_t cycles_max = 0;
+    FOC_Observer_t observer;
+    FOC_Alpha_Beta_Q15_t i_AlphaBeta, v_AlphaBeta;
+    FOC_Q15_t sin_q15, cos_q15;
+
+    FOC_Observer_Init(&observer, FOC_OBSERVER_RS, FOC_OBSERVER_LS, FOC_OBSERVER_TS);
+    Benchmark_CycleCounterInit();
+    for (angle = 0; angle < 65536u * 4u; angle += BENCHMARK_ANGLE_STEP)
+    {
+        FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(angle), &sin_q15, &cos_q15);
+        i_AlphaBeta.alpha = (FOC_Q15_t)((cos_q15 * 5461) >> 15);
+        i_AlphaBeta.beta = (FOC_Q15_t)((sin_q15 * 5461) >> 15);
+        v_AlphaBeta.alpha = (FOC_Q15_t)((-sin_q15 * 10923) >> 15);
+        v_AlphaBeta.beta = (FOC_Q15_t)((cos_q15 * 10923) >> 15);
+
+        start = DWT->CYCCNT;
+        FOC_Observer_Update(&observer, &i_AlphaBeta, &v_AlphaBeta);
+        cycles = DWT->CYCCNT - start;
+        cycles_total += cycles;
+        if (cycles > cycles_max)
+        {
+            cycles_max = cycles;
+        }
+        count++;
+    }
+
+    Benchmark_WaitDebugIdle();
+    debug("observer mean:%lu cycles, max:%lu cycles, budget:%u cycles %s\r\n",
+          (unsigned long)(cycles_total / count),
+          (unsigned long)cycles_max,
+          FOC_OBSERVER_CYCLE_BUDGET,
+          (cycles_max <= FOC_OBSERVER_CYCLE_BUDGET) ? "ok" : "over");
+}
+
+/********************************************************************************
+ * atan2与矢量幅值对比
+ * atan2：libm软浮点atan2f 与 FOC_Atan2_Q15（CORDIC）
+ * 幅值：CMSIS-DSP arm_sqrt_q31(x² + y²) 与 FOC_Magnitude_Q15（CORDIC）
+ * 扫描整周电角度与多个幅值，输出平均、最大周期数以及CORDIC相对参考值的最大误差
+ * （角度误差单位为16位电角度LSB，幅值误差单位为Q15 LSB）
+ *********************************************************************************/
+void FOC_Benchmark_Atan2(void)
+{
+    uint32_t angle, start, cycles, cycles_total;
+    uint32_t count = 0;
+    uint32_t cycles_atan2f = 0;
+    uint32_t cycles_cordic = 0;
+    uint32_t cycles_sqrt = 0;
+    uint32_t cycles_mag = 0;
+    uint32_t cycles_max = 0;
+    float angle_error, max_angle_error = 0.0f;
+    int32_t mag_error, max_mag_error = 0;
+    volatile float sink_float;
+    volatile FOC_Angle_t sink_angle;
+    FOC_Q15_t amplitude, sin_q15, cos_q15, x, y;
+    FOC_Q31_t mag_cordic;
+    q31_t mag_sqrt;
+    float theta;
+
+    Benchmark_CycleCounterInit();
+    /* x² + y² 须小于1（Q31），幅值不超过0.7 */
+    for (amplitude = 1024; amplitude <= 22528; amplitude += 7168)
+    {
+        for (angle = 0; angle < 65536u; angle += BENCHMARK_ANGLE_STEP)
+        {
+            FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(angle), &sin_q15, &cos_q15);
+            x = (FOC_Q15_t)((amplitude * cos_q15) >> 15);
+            y = (FOC_Q15_t)((amplitude * sin_q15) >> 15);
+
+            start = DWT->CYCCNT;
+            theta = atan2f((float)y, (float)x);
+            cycles_atan2f += DWT->CYCCNT - start;
+            sink_float = theta;
+
+            start = DWT->CYCCNT;
+            sink_angle = FOC_Atan2_Q15(y, x);
+            cycles = DWT->CYCCNT - start;
+            cycles_cordic += cycles;
+
+            start = DWT->CYCCNT;
+            arm_sqrt_q31(((q31_t)x * x + (q31_t)y * y) << 1, &mag_sqrt);
+            cycles_sqrt += DWT->CYCCNT - start;
+
+            start = DWT->CYCCNT;
+            mag_cordic = FOC_Magnitude_Q15(x, y);
+            cycles_total = DWT->CYCCNT - start;
+            cycles_mag += cycles_total;
+            cycles_total += cycles;
+            if (cycles_total > cycles_max)
+            {
+                cycles_max = cycles_total;
+            }
+
+            angle_error = fabsf((float)FOC_Angle_Diff(sink_angle, FOC_Angle_FromRad(theta))) / (float)(1u << (FOC_ANGLE_BITS - 16));
+            if (angle_error > max_angle_error)
+            {
+                max_angle_error = angle_error;
+            }
+            mag_error = abs(mag_cordic - (mag_sqrt >> 16));
+            if (mag_error > max_mag_error)
+            {
+                max_mag_error = mag_error;
+            }
+            count++;
+        }
+    }
+    (void)sink_float;
+
+    Benchmark_WaitDebugIdle();
+    debug("atan2f:%lu cycles, cordic:%lu cycles, max error:%.2f lsb\r\n",
+          (unsigned long)(cycles_atan2f / count),
+          (unsigned long)(cycles_cordic / count),
+          max_angle_error);
+    Benchmark_WaitDebugIdle();
+    debug("arm_sqrt_q31:%lu cycles, cordic:%lu cycles, max error:%ld lsb, cordic atan2+mag max:%lu cycles\r\n",
+          (unsigned long)(cycles_sqrt / count),
+          (unsigned long)(cycles_mag / count),
+          (long)max_mag_error,
+          (unsigned long)cycles_max);
+}
+
+/********************************************************************************
+ * 电流环中断链耗时（flash与SRAM执行对比）
+ * 以恒幅旋转的合成三相电流驱动FOC_CurrentLoop_Update（Clarke/Park -> PI -> Park逆变换 -> SVPWM -> 死区补偿）
+ * 与FOC_Observer_Update，测量时关中断，避免电流环中断混入；输出平均与最大周期数，
+ * 标注当前代码位置（FOC_RAM_EXEC_NAME），分别以foc_ramfunc.h中FOC_RAM_EXEC为0、1编译运行两次得到对比，
+ * 结果记在foc_ramfunc.h中作为是否在SRAM执行的依据
+ *********************************************************************************/
+void FOC_Benchmark_CurrentLoop(FOC_SVPWM_t *pwm)
+{
+    uint32_t angle, start, cycles;
+    uint32_t count = 0;
+    uint32_t cycles_total = 0;
+    uint32_t cycles_max = 0;
+    FOC_CurrentLoop_t loop;
+    FOC_Observer_t observer;
+    FOC_U_V_W_Q15_t i_uvw;
+    FOC_Alpha_Beta_Q15_t v_prev;
+    FOC_Q15_t sin_q15, cos_q15;
+
+    FOC_CurrentLoop_Init(&loop, pwm, FOC_CURRENT_KP, FOC_CURRENT_KI);
+    FOC_Observer_Init(&observer, FOC_OBSERVER_RS, FOC_OBSERVER_LS, FOC_OBSERVER_TS);
+    loop.i_ref.iq = 5461;
+    Benchmark_CycleCounterInit();
+    for (angle = 0; angle < 65536u * 4u; angle += BENCHMARK_ANGLE_STEP)
+    {
+        /* iu = I * cosθ，iv、iw滞后120°、240°，cos(θ - 120°) = -cosθ/2 + √3/2 * sinθ */
+        FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(angle), &sin_q15, &cos_q15);
+        i_uvw.iu = (FOC_Q15_t)((cos_q15 * 5461) >> 15);
+        i_uvw.iv = (FOC_Q15_t)(((-cos_q15 * 2731) >> 15) + ((sin_q15 * 4729) >> 15));
+        i_uvw.iw = (FOC_Q15_t)(-i_uvw.iu - i_uvw.iv);
+        v_prev = loop.v_AlphaBeta;
+
+        __disable_irq();
+        start = DWT->CYCCNT;
+        FOC_CurrentLoop_Update(&loop, &i_uvw, FOC_ANGLE_FROM_U16(angle));
+        FOC_Observer_Update(&observer, &loop.i_AlphaBeta, &v_prev);
+        cycles = DWT->CYCCNT - start;
+        __enable_irq();
+        cycles_total += cycles;
+        if (cycles > cycles_max)
+        {
+            cycles_max = cycles;
+        }
+        count++;
+    }
+
+    Benchmark_WaitDebugIdle();
+    debug("current loop (%s) mean:%lu cycles, max:%lu cycles, %lu%% of the PWM period\r\n",
+          FOC_RAM_EXEC_NAME,
+          (unsigned long)(cycles_total / count),
+          (unsigned long)cycles_max,
+          (unsigned long)(cycles_max * 100u / (2u * pwm->htim->Init.Period)));
+}
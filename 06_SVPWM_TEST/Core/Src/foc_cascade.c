@@ -0,0 +1,182 @@
+#include "foc_cascade.h"
+
+static const char *const Cascade_Name[FOC_LOOP_NUM] =
+    {
+    "current",
+    "speed",
+    "position",
+};
+
+/* countdown从phase + 1开始递减，第phase个PWM周期首次执行 */
+static void Cascade_TaskInit(FOC_LoopTask_t *task, uint16_t divider, uint16_t phase, uint32_t budget)
+{
+    task->divider = divider;
+    task->countdown = (uint16_t)(phase + 1u);
+    task->budget = budget;
+    task->time_max = 0;
+    task->run_count = 0;
+    task->overrun = 0;
+}
+
+/********************************************************************************
+ * 串级控制初始化
+ * angle为当前电角度，ts为PWM周期（s）；
+ * 速度环、位置环增益按物理单位给出，这里换算为Q15标幺值下的PI增益
+ *********************************************************************************/
+void FOC_Cascade_Init(FOC_Cascade_t *cascade, FOC_Angle_t angle, float ts)
+{
+    Cascade_TaskInit(&cascade->task[FOC_LOOP_CURRENT], 1u, 0u, FOC_PROFILE_FROM_CYCLES(FOC_CURRENT_LOOP_CYCLE_BUDGET));
+    Cascade_TaskInit(&cascade->task[FOC_LOOP_SPEED], FOC_SPEED_LOOP_DIV, FOC_SPEED_LOOP_PHASE,
+                     FOC_PROFILE_FROM_CYCLES(FOC_SPEED_LOOP_CYCLE_BUDGET));
+    Cascade_TaskInit(&cascade->task[FOC_LOOP_POSITION], FOC_POSITION_LOOP_DIV, FOC_POSITION_LOOP_PHASE,
+                     FOC_PROFILE_FROM_CYCLES(FOC_POSITION_LOOP_CYCLE_BUDGET));
+
+    /* 速度误差（Q15，基值FOC_SPEED_BASE） -> q轴电流（Q15，基值FOC_Q15_BASE） */
+    FOC_PI_Init(&cascade->pi_speed,
+                FOC_SPEED_KP * (FOC_SPEED_BASE / FOC_Q15_BASE),
+                FOC_SPEED_KI * (FOC_SPEED_BASE / FOC_Q15_BASE),
+                FOC_FLOAT_TO_Q15(FOC_SPEED_IQ_MAX));
+    /* 位置误差1LSB为 2^FOC_POSITION_SHIFT 个16位电角度单位，只用比例 */
+    FOC_PI_Init(&cascade->pi_position,
+                FOC_POSITION_KP * (_2PI * (float)(1u << FOC_POSITION_SHIFT) / 65536.0f) * (32768.0f / FOC_SPEED_BASE),
+                0.0f,
+                FOC_SPEED_TO_Q15(FOC_POSITION_SPEED_MAX));
+    /* 速度环周期内的16位电角度增量 -> 速度Q15 */
+    cascade->speed_k = (int32_t)(32768.0f * _2PI / (FOC_SPEED_BASE * (float)FOC_SPEED_LOOP_DIV * ts));
+
+    FOC_MTPA_Init();
+    cascade->mode = FOC_CASCADE_MODE_CURRENT;
+    cascade->mtpa = 0;
+    cascade->angle_last = angle;
+    cascade->position = 0;
+    cascade->position_ref = 0;
+    cascade->speed_position = 0;
+    cascade->speed = 0;
+    cascade->speed_ref = 0;
+}
+
+/* 切换运行方式：清除积分，位置、速度给定取当前值，避免切换时的阶跃 */
+void FOC_Cascade_SetMode(FOC_Cascade_t *cascade, uint8_t mode)
+{
+    FOC_PI_Reset(&cascade->pi_speed);
+    FOC_PI_Reset(&cascade->pi_position);
+    cascade->position_ref = cascade->position;
+    cascade->speed_ref = cascade->speed;
+    cascade->mode = mode;
+}
+
+/* 速度环：位置差分得到速度（始终更新），速度方式下输出iq给定，或作为转矩给定经MTPA换算 */
+static FOC_RAMFUNC void Cascade_Speed(FOC_Cascade_t *cascade, FOC_CurrentLoop_t *loop)
+{
+    int64_t delta = (cascade->position - cascade->speed_position) >> (FOC_ANGLE_BITS - 16);
+    FOC_Q15_t out;
+
+    cascade->speed_position = cascade->position;
+    cascade->speed = FOC_Sat_Q15((FOC_Q31_t)((delta * cascade->speed_k) >> 16));
+    if (cascade->mode != FOC_CASCADE_MODE_CURRENT)
+    {
+        out = FOC_PI_Update_Q15(&cascade->pi_speed, FOC_Sat_Q15((FOC_Q31_t)cascade->speed_ref - cascade->speed));
+        if (cascade->mtpa)
+        {
+            FOC_MTPA_Reference(out, &loop->i_ref);
+        }
+        else
+        {
+            loop->i_ref.iq = out;
+        }
+    }
+}
+
+/* 位置环：输出速度给定，误差超出±8圈电角度时饱和 */
+static FOC_RAMFUNC void Cascade_Position(FOC_Cascade_t *cascade)
+{
+    int64_t error;
+
+    if (cascade->mode != FOC_CASCADE_MODE_POSITION)
+    {
+        return;
+    }
+    error = (cascade->position_ref - cascade->position) >> (FOC_ANGLE_BITS - 16 + FOC_POSITION_SHIFT);
+    if (error > 32767)
+    {
+        error = 32767;
+    }
+    else if (error < -32768)
+    {
+        error = -32768;
+    }
+    cascade->speed_ref = FOC_PI_Update_Q15(&cascade->pi_position, (FOC_Q15_t)error);
+}
+
+/********************************************************************************
+ * 串级控制更新：在电流环之后每个PWM周期调用一次
+ * 累加多圈位置，按分频执行速度环、位置环；输出的iq给定在下一个PWM周期生效
+ *********************************************************************************/
+FOC_RAMFUNC void FOC_Cascade_Update(FOC_Cascade_t *cascade, FOC_CurrentLoop_t *loop, FOC_Angle_t angle)
+{
+    FOC_LoopTask_t *task;
+    uint32_t start;
+
+    cascade->position += FOC_Angle_Diff(angle, cascade->angle_last);
+    cascade->angle_last = angle;
+
+    task = &cascade->task[FOC_LOOP_SPEED];
+    if (--task->countdown == 0)
+    {
+        task->countdown = task->divider;
+        start = FOC_Profile_Now();
+        Cascade_Speed(cascade, loop);
+        FOC_Cascade_Record(task, FOC_Profile_Now() - start);
+    }
+    task = &cascade->task[FOC_LOOP_POSITION];
+    if (--task->countdown == 0)
+    {
+        task->countdown = task->divider;
+        start = FOC_Profile_Now();
+        Cascade_Position(cascade);
+        FOC_Cascade_Record(task, FOC_Profile_Now() - start);
+    }
+}
+
+/* 记录一次执行耗时，超出budget计为一次超时 */
+FOC_RAMFUNC void FOC_Cascade_Record(FOC_LoopTask_t *task, uint32_t elapsed)
+{
+    task->run_count++;
+    if (elapsed > task->time_max)
+    {
+        task->time_max = elapsed;
+    }
+    if (elapsed > task->budget)
+    {
+        task->overrun++;
+    }
+}
+
+/********************************************************************************
+ * 通过USART1输出各控制环的执行次数、最大耗时与超时次数
+ *********************************************************************************/
+void FOC_Cascade_Report(const FOC_Cascade_t *cascade)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_LOOP_NUM; i++)
+    {
+        const FOC_LoopTask_t *task = &cascade->task[i];
+
+#ifndef FOC_HOST_BUILD
+        /* debug()使用DMA发送，等待上一行发送完成 */
+        while (huart1.gState != HAL_UART_STATE_READY)
+        {
+        }
+#endif
+        debug("%s div:%u n:%lu max:%lu %s budget:%lu %s overrun:%lu\r\n",
+              Cascade_Name[i],
+              (unsigned)task->divider,
+              (unsigned long)task->run_count,
+              (unsigned long)task->time_max,
+              FOC_PROFILE_UNIT,
+              (unsigned long)task->budget,
+              FOC_PROFILE_UNIT,
+              (unsigned long)task->overrun);
+    }
+}
@@ -0,0 +1,413 @@
+#include "foc_control.h"
+
+FOC_Control_t FOC_Control[FOC_MOTOR_COUNT];
+
+/********************************************************************************
+ * FOC控制初始化（每个电机调用一次）
+ * 按htim初始化该电机的调制器；启动ADC注入组后，前FOC_ADC_OFFSET_SAMPLES次
+ * 采样用于零偏校准，期间三相50%占空比输出，相电流为零
+ * htim_encoder：编码器模式定时器，htim_edge：霍尔接口模式定时器（编码器边沿时间）
+ * htim_hall：霍尔传感器接口模式定时器（霍尔传感器）；没有接入的传感器传NULL
+ * 母线电压规则组配置模拟看门狗（上限FOC_FAULT_UDC_TRIP），与电流环共用ADC中断，
+ * 只在越限时进入看门狗处理，正常运行时电流环中断耗时不变
+ *********************************************************************************/
+void FOC_Control_Init(FOC_Control_t *ctrl, ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim, TIM_HandleTypeDef *htim_encoder,
+                      TIM_HandleTypeDef *htim_edge, TIM_HandleTypeDef *htim_hall)
+{
+    const FOC_PWMConfig_t *pwm;
+    ADC_AnalogWDGConfTypeDef awd = {0};
+    uint8_t i;
+
+    ctrl->hadc = hadc;
+    ctrl->htim = htim;
+    FOC_SVPWM_Init(&ctrl->svpwm, htim);
+    pwm = FOC_SVPWM_GetConfig(&ctrl->svpwm);
+    for (i = 0; i < 3; i++)
+    {
+        ctrl->adc_offset[i] = 2048;
+        ctrl->offset_sum[i] = 0;
+    }
+    ctrl->offset_count = 0;
+    ctrl->ready = 0;
+    ctrl->udc = 32768u;
+    ctrl->vbus_filter = (uint32_t)ctrl->udc << FOC_VBUS_FILTER_SHIFT;
+    ctrl->angle = 0;
+    ctrl->angle_step = 0;
+    ctrl->angle_source = FOC_ANGLE_SOURCE_OPENLOOP;
+    ctrl->isr_count = 0;
+    FOC_CurrentLoop_Init(&ctrl->current_loop, &ctrl->svpwm, FOC_CURRENT_KP, FOC_CURRENT_KI);
+    FOC_Observer_Init(&ctrl->observer, FOC_OBSERVER_RS, FOC_OBSERVER_LS, FOC_OBSERVER_TS);
+    FOC_Cascade_Init(&ctrl->cascade, ctrl->angle, FOC_OBSERVER_TS);
+    /* 中心对齐：一个PWM周期为2*ARR个定时器时钟 */
+    ctrl->encoder.htim_count = NULL;
+    if (htim_encoder != NULL)
+    {
+        FOC_Encoder_Init(&ctrl->encoder, htim_encoder, htim_edge, 2u * pwm->period);
+        FOC_Encoder_Start(&ctrl->encoder);
+    }
+    ctrl->hall.htim = NULL;
+    if (htim_hall != NULL)
+    {
+        FOC_Hall_Init(&ctrl->hall, htim_hall, 2u * pwm->period);
+        FOC_Hall_Start(&ctrl->hall);
+    }
+    FOC_FieldWeak_Init(&ctrl->field_weak);
+    FOC_Ident_Init(&ctrl->ident, FOC_OBSERVER_TS);
+    FOC_Startup_Init(&ctrl->startup, FOC_OBSERVER_TS);
+
+    __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_1, pwm->period >> 1);
+    __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_2, pwm->period >> 1);
+    __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_3, pwm->period >> 1);
+    __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_4, pwm->period - FOC_ADC_TRIGGER_LEAD);
+
+    FOC_Fault_Init(&ctrl->fault, htim);
+
+    if (HAL_ADCEx_Calibration_Start(hadc) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    awd.WatchdogMode = ADC_ANALOGWATCHDOG_ALL_REG;
+    awd.Channel = 0;
+    awd.ITMode = ENABLE;
+    awd.HighThreshold = (uint32_t)(FOC_FAULT_UDC_TRIP / FOC_ADC_VBUS_PER_LSB);
+    awd.LowThreshold = 0;
+    if (HAL_ADC_AnalogWDGConfig(hadc, &awd) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    if (HAL_ADCEx_InjectedStart_IT(hadc) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    if (HAL_ADC_Start_DMA(hadc, (uint32_t *)ctrl->vbus_adc, FOC_VBUS_SAMPLES) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    /* 缓冲区只在电流环中断中读取，不需要DMA传输中断 */
+    __HAL_DMA_DISABLE_IT(hadc->DMA_Handle, DMA_IT_TC | DMA_IT_HT);
+}
+
+/********************************************************************************
+ * 同步启动各电机的PWM计数器，在各路PWM输出使能、全部FOC_Control_Init之后调用一次
+ * 各定时器同一时钟与ARR，停止后预置计数器：电机0从0开始，电机1从ARR（计数器顶点）开始，
+ * 两路PWM相差半个周期，两个注入组触发、两个电流环中断也相隔半个周期交错执行；
+ * 两个JEOC中断同一抢占优先级，单个中断耗时不超过半个PWM周期时互不重叠，
+ * 峰值CPU负载与单电机相同，只是平均负载加倍
+ * 中心对齐模式下DIR只读，预置值附近的计数方向差别只有一个计数
+ *********************************************************************************/
+void FOC_Control_StartPWM(void)
+{
+    TIM_TypeDef *tim;
+    uint8_t i;
+
+    __disable_irq();
+    for (i = 0; i < FOC_MOTOR_COUNT; i++)
+    {
+        tim = FOC_Control[i].htim->Instance;
+        tim->CR1 &= ~TIM_CR1_CEN;
+        tim->CNT = (i == 0) ? 0 : FOC_Control[i].htim->Init.Period;
+    }
+    for (i = 0; i < FOC_MOTOR_COUNT; i++)
+    {
+        FOC_Control[i].htim->Instance->CR1 |= TIM_CR1_CEN;
+    }
+    __enable_irq();
+}
+
+/********************************************************************************
+ * 开环启动：定位 -> I/f加速 -> 切换到angle_source（FOC_ANGLE_SOURCE_OBSERVER或ENCODER）与速度环
+ * 启动期间串级控制只运行电流环，完成后startup.state为FOC_STARTUP_DONE，速度环以I/f末速度运行；
+ * 状态为FOC_STARTUP_FAULT时电流给定已清零，需要检查后重新启动；
+ * 故障锁存或恢复确认期间不启动
+ * 串级控制复位（含64位位置给定）与启动状态机初始化在关中断期间完成，电流环中断不会看到一半的状态
+ *********************************************************************************/
+void FOC_Control_Startup(FOC_Control_t *ctrl, uint8_t angle_source)
+{
+    __disable_irq();
+    if (ctrl->fault.state == FOC_FAULT_STATE_NONE)
+    {
+        FOC_Cascade_SetMode(&ctrl->cascade, FOC_CASCADE_MODE_CURRENT);
+        ctrl->angle_source = angle_source;
+        FOC_Startup_Start(&ctrl->startup);
+    }
+    __enable_irq();
+}
+
+/********************************************************************************
+ * 母线电压：DMA缓冲区平均 -> 一阶低通 -> 更新调制器的母线电压倒数
+ * 零偏校准期间同样运行，校准结束时滤波器已稳定
+ *********************************************************************************/
+static FOC_RAMFUNC void FOC_Control_UpdateBus(FOC_Control_t *ctrl)
+{
+    uint32_t sum = 0;
+    uint32_t udc;
+    uint8_t i;
+    FOC_PROFILE_START(FOC_PROFILE_VBUS);
+
+    for (i = 0; i < FOC_VBUS_SAMPLES; i++)
+    {
+        sum += ctrl->vbus_adc[i];
+    }
+    udc = (sum * FOC_VBUS_Q15_PER_LSB) >> (8 + FOC_VBUS_SAMPLES_SHIFT);
+    ctrl->vbus_filter += udc - (ctrl->vbus_filter >> FOC_VBUS_FILTER_SHIFT);
+    udc = ctrl->vbus_filter >> FOC_VBUS_FILTER_SHIFT;
+    ctrl->udc = (udc > 65535u) ? 65535u : (uint16_t)udc;
+    FOC_SVPWM_SetBusVoltage(&ctrl->svpwm, ctrl->udc);
+    FOC_PROFILE_STOP(FOC_PROFILE_VBUS);
+}
+
+/* 电流采样（CH4触发，计数器上升段）到当前时刻的定时器时钟数，用于编码器角度插值 */
+static FOC_RAMFUNC uint32_t FOC_Control_SampleDelay(const FOC_Control_t *ctrl)
+{
+    uint32_t period = ctrl->htim->Init.Period;
+    uint32_t cnt = ctrl->htim->Instance->CNT;
+
+    if (ctrl->htim->Instance->CR1 & TIM_CR1_DIR)
+    {
+        return FOC_ADC_TRIGGER_LEAD + (period - cnt);
+    }
+    return (cnt > period - FOC_ADC_TRIGGER_LEAD) ? (cnt - (period - FOC_ADC_TRIGGER_LEAD)) : 0;
+}
+
+/********************************************************************************
+ * 电流环中断：每个PWM周期执行一次
+ * 采样 -> 编码器、霍尔 -> 母线电压前馈 -> 开环启动或弱磁 -> Clarke -> Park -> PI -> Park逆变换 -> SVPWM -> 比较值 -> 无感观测器
+ * -> 速度环/位置环（分频执行，同一周期最多一个）
+ * 比较值经预装载在下一个更新事件（计数器归零）生效，采样到输出的延迟固定为半个PWM周期；
+ * 整个中断的耗时记入cascade.task[FOC_LOOP_CURRENT]，超出预算计为超时
+ *********************************************************************************/
+FOC_RAMFUNC void FOC_Control_ISR(FOC_Control_t *ctrl)
+{
+    const FOC_PWMCounter_t *counter;
+    FOC_Alpha_Beta_Q15_t v_prev;
+    uint16_t adc[3];
+    uint8_t i;
+    uint32_t delay;
+    uint32_t start = FOC_Profile_Now();
+    FOC_PROFILE_START(FOC_PROFILE_CONTROL_ISR);
+
+    adc[0] = (uint16_t)HAL_ADCEx_InjectedGetValue(ctrl->hadc, ADC_INJECTED_RANK_1);
+    adc[1] = (uint16_t)HAL_ADCEx_InjectedGetValue(ctrl->hadc, ADC_INJECTED_RANK_2);
+    adc[2] = (uint16_t)HAL_ADCEx_InjectedGetValue(ctrl->hadc, ADC_INJECTED_RANK_3);
+    delay = FOC_Control_SampleDelay(ctrl);
+    if (ctrl->encoder.htim_count != NULL)
+    {
+        FOC_Encoder_Read(&ctrl->encoder, delay);
+    }
+    if (ctrl->hall.htim != NULL)
+    {
+        FOC_Hall_Read(&ctrl->hall, delay);
+    }
+    FOC_Control_UpdateBus(ctrl);
+
+    if (ctrl->ready == 0)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            ctrl->offset_sum[i] += adc[i];
+        }
+        if (++ctrl->offset_count >= FOC_ADC_OFFSET_SAMPLES)
+        {
+            for (i = 0; i < 3; i++)
+            {
+                ctrl->adc_offset[i] = (uint16_t)(ctrl->offset_sum[i] / FOC_ADC_OFFSET_SAMPLES);
+            }
+            ctrl->ready = 1;
+        }
+        return;
+    }
+
+    ctrl->i_uvw.iu = FOC_Sat_Q15((((int32_t)adc[0] - ctrl->adc_offset[0]) * FOC_CURRENT_Q15_PER_LSB) >> 8);
+    ctrl->i_uvw.iv = FOC_Sat_Q15((((int32_t)adc[1] - ctrl->adc_offset[1]) * FOC_CURRENT_Q15_PER_LSB) >> 8);
+    ctrl->i_uvw.iw = FOC_Sat_Q15((((int32_t)adc[2] - ctrl->adc_offset[2]) * FOC_CURRENT_Q15_PER_LSB) >> 8);
+
+    if (ctrl->angle_source == FOC_ANGLE_SOURCE_OBSERVER)
+    {
+        ctrl->angle = ctrl->observer.angle;
+    }
+    else if (ctrl->angle_source == FOC_ANGLE_SOURCE_ENCODER)
+    {
+        ctrl->angle = ctrl->encoder.angle;
+    }
+    else if (ctrl->angle_source == FOC_ANGLE_SOURCE_HALL)
+    {
+        ctrl->angle = ctrl->hall.angle;
+    }
+    else
+    {
+        ctrl->angle += ctrl->angle_step;
+    }
+    /* 上一周期计算的电压在本周期内起作用，供观测器使用 */
+    v_prev = ctrl->current_loop.v_AlphaBeta;
+    if (FOC_Ident_Busy(&ctrl->ident))
+    {
+        counter = FOC_Ident_Update(&ctrl->ident, &ctrl->current_loop, &ctrl->i_uvw);
+        if (ctrl->ident.state == FOC_IDENT_DONE)
+        {
+            FOC_Ident_Apply(&ctrl->ident, &ctrl->current_loop, &ctrl->observer);
+        }
+    }
+    else
+    {
+        if (FOC_Startup_Busy(&ctrl->startup))
+        {
+            /* ctrl->angle此时为位置估计，启动期间由开环角度或切换中的角度代替 */
+            ctrl->angle = FOC_Startup_Update(&ctrl->startup, &ctrl->current_loop, ctrl->angle);
+            if (ctrl->startup.state == FOC_STARTUP_DONE)
+            {
+                FOC_Startup_Apply(&ctrl->startup, &ctrl->current_loop, &ctrl->cascade);
+            }
+        }
+        else
+        {
+            FOC_FieldWeak_Update(&ctrl->field_weak, &ctrl->current_loop);
+        }
+        counter = FOC_CurrentLoop_Update(&ctrl->current_loop, &ctrl->i_uvw, ctrl->angle);
+    }
+    {
+        FOC_PROFILE_START(FOC_PROFILE_COMPARE_WRITE);
+        __HAL_TIM_SET_COMPARE(ctrl->htim, TIM_CHANNEL_1, counter->counter_0);
+        __HAL_TIM_SET_COMPARE(ctrl->htim, TIM_CHANNEL_2, counter->counter_1);
+        __HAL_TIM_SET_COMPARE(ctrl->htim, TIM_CHANNEL_3, counter->counter_2);
+        FOC_PROFILE_STOP(FOC_PROFILE_COMPARE_WRITE);
+    }
+    FOC_Observer_Update(&ctrl->observer, &ctrl->current_loop.i_AlphaBeta, &v_prev);
+    FOC_Cascade_Update(&ctrl->cascade, &ctrl->current_loop, ctrl->angle);
+    ctrl->isr_count++;
+    FOC_Cascade_Record(&ctrl->cascade.task[FOC_LOOP_CURRENT], FOC_Profile_Now() - start);
+    FOC_PROFILE_STOP(FOC_PROFILE_CONTROL_ISR);
+}
+
+FOC_RAMFUNC void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_MOTOR_COUNT; i++)
+    {
+        if (hadc == FOC_Control[i].hadc)
+        {
+            FOC_Control_ISR(&FOC_Control[i]);
+        }
+    }
+}
+
+/* 故障关断后中止正在进行的开环启动与参数辨识，恢复后须重新开始 */
+static void FOC_Control_Abort(FOC_Control_t *ctrl)
+{
+    if (FOC_Startup_Busy(&ctrl->startup))
+    {
+        ctrl->startup.state = FOC_STARTUP_FAULT;
+    }
+    if (FOC_Ident_Busy(&ctrl->ident))
+    {
+        ctrl->ident.state = FOC_IDENT_FAULT;
+    }
+}
+
+/* 刹车输入：输出已被硬件关断，这里只做记录 */
+void HAL_TIMEx_BreakCallback(TIM_HandleTypeDef *htim)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_MOTOR_COUNT; i++)
+    {
+        if (htim == FOC_Control[i].htim)
+        {
+            FOC_Fault_Break(&FOC_Control[i].fault);
+            FOC_Control_Abort(&FOC_Control[i]);
+        }
+    }
+}
+
+/* 母线电压模拟看门狗：软件刹车；规则组连续转换，越限期间每次转换都会置位，先关闭看门狗中断，恢复时再打开 */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_MOTOR_COUNT; i++)
+    {
+        if (hadc == FOC_Control[i].hadc)
+        {
+            __HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);
+            FOC_Fault_Trigger(&FOC_Control[i].fault, FOC_FAULT_OVERVOLTAGE);
+            FOC_Control_Abort(&FOC_Control[i]);
+        }
+    }
+}
+
+/********************************************************************************
+ * 温度采样（0.1°C），由主循环按温度传感器的采样周期调用
+ * 开发板没有接温度传感器，使用时由应用按实际的NTC或驱动芯片温度输出换算后传入
+ * 返回1表示本次触发了过温关断
+ *********************************************************************************/
+uint8_t FOC_Control_Temperature(FOC_Control_t *ctrl, int16_t temperature)
+{
+    uint8_t trip;
+
+    __disable_irq();
+    trip = FOC_Fault_CheckTemperature(&ctrl->fault, temperature);
+    if (trip)
+    {
+        FOC_Control_Abort(ctrl);
+    }
+    __enable_irq();
+    return trip;
+}
+
+/* 故障管理慢速任务，由主循环调用；关中断执行，确认结束改写状态时不会覆盖同时发生的故障锁存 */
+void FOC_Control_FaultTask(FOC_Control_t *ctrl)
+{
+    __disable_irq();
+    FOC_Fault_Task(&ctrl->fault);
+    __enable_irq();
+}
+
+/********************************************************************************
+ * 故障恢复，由主循环调用，返回值见FOC_Fault_Recover
+ * 关中断期间完成检查与电流环复位，恢复成功后重新打开母线电压看门狗中断；
+ * 弱磁积分在关断期间按饱和的调制度累积，一并清零；
+ * 恢复后串级控制为电流方式、电流给定为0，确认阶段结束（fault.state回到NONE）后再启动
+ *********************************************************************************/
+uint8_t FOC_Control_Recover(FOC_Control_t *ctrl)
+{
+    uint8_t result;
+
+    __disable_irq();
+    result = FOC_Fault_Recover(&ctrl->fault, &ctrl->current_loop, &ctrl->cascade, ctrl->udc);
+    if (result == FOC_FAULT_RECOVER_OK)
+    {
+        FOC_FieldWeak_Enable(&ctrl->field_weak, ctrl->field_weak.enable);
+        __HAL_ADC_CLEAR_FLAG(ctrl->hadc, ADC_FLAG_AWD);
+        __HAL_ADC_ENABLE_IT(ctrl->hadc, ADC_IT_AWD);
+    }
+    __enable_irq();
+    return result;
+}
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_MOTOR_COUNT; i++)
+    {
+        if (htim == FOC_Control[i].hall.htim && htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1)
+        {
+            FOC_Hall_Capture(&FOC_Control[i].hall);
+        }
+    }
+}
+
+void FOC_Control_Debug(const FOC_Control_t *ctrl)
+{
+    FOC_PROFILE_START(FOC_PROFILE_DEBUG);
+    debug("%lu,%f,%f,%f,%f,%f,%f,%f\r\n",
+          (unsigned long)ctrl->isr_count,
+          FOC_Angle_ToRad(ctrl->angle),
+          FOC_Q15_TO_FLOAT(ctrl->i_uvw.iu),
+          FOC_Q15_TO_FLOAT(ctrl->i_uvw.iv),
+          FOC_Q15_TO_FLOAT(ctrl->current_loop.i_dq.id),
+          FOC_Q15_TO_FLOAT(ctrl->current_loop.i_dq.iq),
+          FOC_Q15_TO_FLOAT(ctrl->current_loop.v_dq.id),
+          FOC_Q15_TO_FLOAT(ctrl->current_loop.v_dq.iq));
+    FOC_PROFILE_STOP(FOC_PROFILE_DEBUG);
+}
@@ -0,0 +1,201 @@
+#include "foc_encoder.h"
+
+/********************************************************************************
+ * 编码器初始化
+ * htim_count：编码器模式定时器（ARR = CPR - 1）
+ * htim_edge：霍尔传感器接口模式定时器，与htim_count同一时钟
+ * period_ticks：一个PWM周期的定时器时钟计数（中心对齐为2*ARR）
+ * 上电时计数值与转子位置的关系未知，index_found置位前输出角度仅相对有效
+ *********************************************************************************/
+void FOC_Encoder_Init(FOC_Encoder_t *enc, TIM_HandleTypeDef *htim_count, TIM_HandleTypeDef *htim_edge, uint32_t period_ticks)
+{
+    enc->htim_count = htim_count;
+    enc->htim_edge = htim_edge;
+    enc->angle_per_count = (uint32_t)(((uint64_t)FOC_ENCODER_POLE_PAIRS << 32) / FOC_ENCODER_CPR);
+    enc->period_ticks = period_ticks;
+    enc->angle_offset = 0;
+    enc->count = 0;
+    enc->dir = 1;
+    enc->index_found = 0;
+    enc->edge_age = FOC_ENCODER_AGE_MAX;
+    enc->window_count = 0;
+    enc->window_time = FOC_ENCODER_AGE_MAX;
+    enc->window_periods = 0;
+    enc->speed_q32 = 0;
+    enc->speed = 0;
+    enc->angle = 0;
+}
+
+void FOC_Encoder_Start(FOC_Encoder_t *enc)
+{
+#ifndef FOC_HOST_BUILD
+    enc->count = (uint16_t)__HAL_TIM_GET_COUNTER(enc->htim_count);
+    HAL_TIM_Encoder_Start(enc->htim_count, TIM_CHANNEL_ALL);
+    /* CH3与编码器共用定时器，通道状态不由HAL_TIM_IC_Start管理，直接使能捕获 */
+    enc->htim_count->Instance->CCER |= TIM_CCER_CC3E;
+    HAL_TIMEx_HallSensor_Start(enc->htim_edge);
+#else
+    (void)enc;
+#endif
+}
+
+/* 计数值 -> 电角度累加器（2^32对应2π），frac为计数内的插值位置（Q32） */
+static inline uint32_t Encoder_Angle(const FOC_Encoder_t *enc, uint16_t count, uint32_t frac)
+{
+    return enc->angle_offset + (uint32_t)count * enc->angle_per_count
+           + (uint32_t)(((uint64_t)frac * enc->angle_per_count) >> 32);
+}
+
+/* 以当前计数为基准重新标定电角度，用于d轴预定位对齐 */
+void FOC_Encoder_SetAngle(FOC_Encoder_t *enc, FOC_Angle_t angle)
+{
+    uint32_t target = (uint32_t)angle << (32 - FOC_ANGLE_BITS);
+
+    enc->angle_offset = 0;
+    enc->angle_offset = target - Encoder_Angle(enc, enc->count, 0);
+    enc->angle = angle;
+}
+
+/* M/T法：窗口内计数增量 / 起止两个边沿之间的时间 */
+static FOC_RAMFUNC void Encoder_Speed(FOC_Encoder_t *enc)
+{
+    uint32_t time, bound;
+
+    if (++enc->window_periods < FOC_ENCODER_SPEED_WINDOW)
+    {
+        return;
+    }
+    if (enc->window_count != 0)
+    {
+        time = enc->window_time - enc->edge_age;
+        if (time == 0)
+        {
+            return;
+        }
+        enc->speed_q32 = (int32_t)(((int64_t)enc->window_count << 32) / (int64_t)time);
+        /* 新窗口从最近一个边沿开始 */
+        enc->window_count = 0;
+        enc->window_time = enc->edge_age;
+        enc->window_periods = 0;
+    }
+    else
+    {
+        /* 窗口内无边沿：速度不超过"距上个边沿的时间内走一个计数"，低速下逐渐衰减到0 */
+        bound = (uint32_t)(0xFFFFFFFFu / enc->edge_age);
+        if (bound > 0x7FFFFFFFu)
+        {
+            bound = 0x7FFFFFFFu;
+        }
+        if (enc->speed_q32 > (int32_t)bound)
+        {
+            enc->speed_q32 = (int32_t)bound;
+        }
+        else if (enc->speed_q32 < -(int32_t)bound)
+        {
+            enc->speed_q32 = -(int32_t)bound;
+        }
+    }
+}
+
+/********************************************************************************
+ * 编码器单次更新，每个PWM周期在电流采样后调用一次
+ * count：编码器计数值（0 ~ CPR-1）
+ * edge_ticks：距最近一个编码器边沿的时间（定时器时钟计数，16位）
+ * index_count：本周期index脉冲锁存的计数值，未出现时为-1
+ * delay：读取时刻滞后于电流采样时刻的定时器时钟计数，插值回采样时刻
+ *
+ * 边沿位置：正转进入计数n时转子在n处，反转进入计数n时转子在n+1处
+ * 采样时刻位置 = 边沿位置 + 速度 * (edge_age - delay)，限制在当前计数范围内
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Angle_t FOC_Encoder_Update(FOC_Encoder_t *enc, uint16_t count, uint32_t edge_ticks, int32_t index_count, uint32_t delay)
+{
+    int32_t delta;
+    int64_t frac;
+    uint32_t age, angle;
+    FOC_PROFILE_START(FOC_PROFILE_ENCODER);
+
+    delta = (int32_t)count - enc->count;
+    if (delta > (int32_t)(FOC_ENCODER_CPR / 2u))
+    {
+        delta -= (int32_t)FOC_ENCODER_CPR;
+    }
+    else if (delta < -(int32_t)(FOC_ENCODER_CPR / 2u))
+    {
+        delta += (int32_t)FOC_ENCODER_CPR;
+    }
+    enc->count = count;
+
+    if (delta != 0)
+    {
+        /* 本周期内有边沿，霍尔接口定时器在最后一个边沿处复位 */
+        enc->dir = (delta > 0) ? 1 : -1;
+        enc->edge_age = edge_ticks;
+        enc->window_count += delta;
+    }
+    else if (enc->edge_age < FOC_ENCODER_AGE_MAX)
+    {
+        enc->edge_age += enc->period_ticks;
+    }
+    if (enc->window_time < FOC_ENCODER_AGE_MAX)
+    {
+        enc->window_time += enc->period_ticks;
+    }
+    if (delta != 0 && enc->window_time >= FOC_ENCODER_AGE_MAX)
+    {
+        /* 静止后的第一个边沿作为窗口起点 */
+        enc->window_count = 0;
+        enc->window_time = edge_ticks;
+        enc->window_periods = 0;
+    }
+    Encoder_Speed(enc);
+
+    /* index对齐，每次经过index都重新计算，消除丢脉冲造成的累积误差 */
+    if (index_count >= 0)
+    {
+        enc->angle_offset = 0;
+        enc->angle_offset = ((uint32_t)FOC_ENCODER_INDEX_ANGLE << 16) - Encoder_Angle(enc, (uint16_t)index_count, 0);
+        enc->index_found = 1;
+    }
+
+    age = (enc->edge_age > delay) ? (enc->edge_age - delay) : 0;
+    frac = (enc->dir < 0) ? ((int64_t)1 << 32) : 0;
+    frac += (int64_t)enc->speed_q32 * age;
+    if (frac < 0)
+    {
+        frac = 0;
+    }
+    else if (frac > 0xFFFFFFFFLL)
+    {
+        frac = 0xFFFFFFFFLL;
+    }
+    angle = Encoder_Angle(enc, count, (uint32_t)frac);
+    /* 每个PWM周期的电角度增量 */
+    enc->speed = (int32_t)(((int64_t)enc->speed_q32 * enc->period_ticks * (int64_t)enc->angle_per_count) >> 32);
+    enc->angle = (FOC_Angle_t)(angle >> (32 - FOC_ANGLE_BITS));
+    FOC_PROFILE_STOP(FOC_PROFILE_ENCODER);
+    return enc->angle;
+}
+
+/********************************************************************************
+ * 读取定时器并更新，在电流环中断开始处调用
+ * 编码器计数与边沿时间连续读取，两次读取之间出现边沿的误差不超过一个计数
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Angle_t FOC_Encoder_Read(FOC_Encoder_t *enc, uint32_t delay)
+{
+    uint16_t count = (uint16_t)__HAL_TIM_GET_COUNTER(enc->htim_count);
+    uint32_t edge_ticks = __HAL_TIM_GET_COUNTER(enc->htim_edge);
+    int32_t index_count = -1;
+
+    if (__HAL_TIM_GET_FLAG(enc->htim_count, TIM_FLAG_CC3))
+    {
+        __HAL_TIM_CLEAR_FLAG(enc->htim_count, TIM_FLAG_CC3);
+        index_count = (int32_t)__HAL_TIM_GET_COMPARE(enc->htim_count, TIM_CHANNEL_3);
+    }
+    return FOC_Encoder_Update(enc, count, edge_ticks, index_count, delay);
+}
+
+/* 电角速度（rad/s），ts为PWM周期 */
+float FOC_Encoder_GetSpeed(const FOC_Encoder_t *enc, float ts)
+{
+    return (float)enc->speed * (6.283185307f / 4294967296.0f) / ts;
+}
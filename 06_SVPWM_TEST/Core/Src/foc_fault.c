@@ -0,0 +1,224 @@
+#include "foc_fault.h"
+
+static const char *const Fault_Name[FOC_FAULT_CAUSE_NUM] = {"overcurrent", "overvoltage", "overtemp"};
+
+/********************************************************************************
+ * 故障管理初始化，在该定时器PWM输出启动之后调用
+ * 刹车输入是否使能取自BDTR.BKE（tim.c中的BreakState）；使能时打开刹车中断，
+ * 上电时刹车输入已经有效（BIF已置位，MOE已被硬件清除）则直接锁存为过流
+ *********************************************************************************/
+void FOC_Fault_Init(FOC_Fault_t *fault, TIM_HandleTypeDef *htim)
+{
+    uint8_t i;
+
+    fault->htim = htim;
+    fault->break_input = (htim->Instance->BDTR & TIM_BDTR_BKE) ? 1 : 0;
+    fault->state = FOC_FAULT_STATE_NONE;
+    fault->cause = 0;
+    fault->first = 0;
+    fault->retry = 0;
+    fault->tick = 0;
+    fault->cycle = 0;
+    fault->recover_tick = 0;
+    fault->udc_recover = (uint16_t)(FOC_FAULT_UDC_RECOVER * (32768.0f / FOC_Q15_BASE));
+    fault->temperature = 0;
+    for (i = 0; i < FOC_FAULT_CAUSE_NUM; i++)
+    {
+        fault->count[i] = 0;
+    }
+    fault->log_count = 0;
+
+    if (fault->break_input)
+    {
+        if (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_BREAK))
+        {
+            FOC_Fault_Trigger(fault, FOC_FAULT_OVERCURRENT);
+        }
+        else
+        {
+            __HAL_TIM_ENABLE_IT(htim, TIM_IT_BREAK);
+        }
+    }
+}
+
+/* 记录一次故障：正常或确认中 -> 锁存（重试次数用尽时锁死），锁存期间只累加原因 */
+static void Fault_Record(FOC_Fault_t *fault, uint8_t cause)
+{
+    FOC_FaultRecord_t *rec = &fault->log[fault->log_count % FOC_FAULT_LOG_SIZE];
+    uint32_t tick = HAL_GetTick();
+    uint32_t cycle = FOC_Profile_Now();
+    uint8_t i;
+
+    rec->cause = cause;
+    rec->state = fault->state;
+    rec->tick = tick;
+    rec->cycle = cycle;
+    fault->log_count++;
+    for (i = 0; i < FOC_FAULT_CAUSE_NUM; i++)
+    {
+        if (cause & (1u << i))
+        {
+            fault->count[i]++;
+        }
+    }
+
+    if (fault->state == FOC_FAULT_STATE_NONE || fault->state == FOC_FAULT_STATE_CONFIRM)
+    {
+        /* 恢复后FOC_FAULT_RETRY_CLEAR内再次故障计为重试 */
+        if (fault->retry >= FOC_FAULT_RETRY_MAX)
+        {
+            fault->state = FOC_FAULT_STATE_LOCKED;
+        }
+        else
+        {
+            fault->state = FOC_FAULT_STATE_LATCHED;
+        }
+        fault->cause = 0;
+        fault->first = cause;
+        fault->tick = tick;
+        fault->cycle = cycle;
+    }
+    fault->cause |= cause;
+}
+
+/********************************************************************************
+ * 刹车中断（HAL_TIMEx_BreakCallback）中调用，此时输出已被硬件关断
+ * 刹车输入为电平有效，撤销之前BIF清除后会立即重新置位，关闭刹车中断避免反复进入，
+ * 恢复时再打开
+ *********************************************************************************/
+void FOC_Fault_Break(FOC_Fault_t *fault)
+{
+    __HAL_TIM_DISABLE_IT(fault->htim, TIM_IT_BREAK);
+    Fault_Record(fault, FOC_FAULT_OVERCURRENT);
+}
+
+/********************************************************************************
+ * 软件刹车：EGR.BG产生刹车事件，输出立即进入空闲电平，再清除MOE保证AOE设置下也不会自动恢复
+ * 软件刹车同样置位BIF，先关闭刹车中断并清除BIF，避免再被记为过流
+ * 在主循环中调用时须关中断，与故障源中断互斥
+ *********************************************************************************/
+void FOC_Fault_Trigger(FOC_Fault_t *fault, uint8_t cause)
+{
+    __HAL_TIM_DISABLE_IT(fault->htim, TIM_IT_BREAK);
+    fault->htim->Instance->EGR = TIM_EGR_BG;
+    __HAL_TIM_MOE_DISABLE_UNCONDITIONALLY(fault->htim);
+    __HAL_TIM_CLEAR_FLAG(fault->htim, TIM_FLAG_BREAK);
+    Fault_Record(fault, cause);
+}
+
+/* 温度采样（0.1°C），超过FOC_FAULT_TEMP_TRIP时软件刹车，返回1表示本次触发了故障 */
+uint8_t FOC_Fault_CheckTemperature(FOC_Fault_t *fault, int16_t temperature)
+{
+    fault->temperature = temperature;
+    if (temperature > FOC_FAULT_TEMP_TRIP && (fault->cause & FOC_FAULT_OVERTEMP) == 0)
+    {
+        FOC_Fault_Trigger(fault, FOC_FAULT_OVERTEMP);
+        return 1;
+    }
+    return 0;
+}
+
+/********************************************************************************
+ * 受控恢复，udc为当前母线电压（无符号Q15）
+ * 检查顺序：锁存状态 -> 锁存时间 -> 各故障条件（刹车输入仍有效时BIF在清除后立即重新置位）；
+ * 全部满足后：串级控制回到电流方式，dq电流给定清零，电流环积分清零，
+ * 清除BIF并重新打开刹车中断，最后使能MOE，进入确认阶段
+ * 调用方须关中断，与电流环中断和故障源中断互斥
+ *********************************************************************************/
+uint8_t FOC_Fault_Recover(FOC_Fault_t *fault, FOC_CurrentLoop_t *loop, FOC_Cascade_t *cascade, uint16_t udc)
+{
+    uint32_t tick = HAL_GetTick();
+    uint8_t active = 0;
+
+    if (fault->state != FOC_FAULT_STATE_LATCHED)
+    {
+        return FOC_FAULT_RECOVER_DENIED;
+    }
+    if (tick - fault->tick < FOC_FAULT_RECOVER_DELAY)
+    {
+        return FOC_FAULT_RECOVER_WAIT;
+    }
+    if (fault->break_input)
+    {
+        __HAL_TIM_CLEAR_FLAG(fault->htim, TIM_FLAG_BREAK);
+        if (__HAL_TIM_GET_FLAG(fault->htim, TIM_FLAG_BREAK))
+        {
+            active |= FOC_FAULT_OVERCURRENT;
+        }
+    }
+    if (udc > fault->udc_recover)
+    {
+        active |= FOC_FAULT_OVERVOLTAGE;
+    }
+    if (fault->temperature > FOC_FAULT_TEMP_RECOVER)
+    {
+        active |= FOC_FAULT_OVERTEMP;
+    }
+    if (active != 0)
+    {
+        return active;
+    }
+
+    FOC_Cascade_SetMode(cascade, FOC_CASCADE_MODE_CURRENT);
+    loop->i_ref.id = 0;
+    loop->i_ref.iq = 0;
+    FOC_PI_Reset(&loop->pi_d);
+    FOC_PI_Reset(&loop->pi_q);
+    if (fault->break_input)
+    {
+        __HAL_TIM_ENABLE_IT(fault->htim, TIM_IT_BREAK);
+    }
+    __HAL_TIM_MOE_ENABLE(fault->htim);
+    fault->retry++;
+    fault->recover_tick = tick;
+    fault->cause = 0;
+    fault->state = FOC_FAULT_STATE_CONFIRM;
+    return FOC_FAULT_RECOVER_OK;
+}
+
+/* 慢速任务：确认阶段计时，无故障运行足够长时间后清除重试计数；调用方须关中断（FOC_Control_FaultTask） */
+void FOC_Fault_Task(FOC_Fault_t *fault)
+{
+    uint32_t elapsed = HAL_GetTick() - fault->recover_tick;
+
+    if (fault->state == FOC_FAULT_STATE_CONFIRM && elapsed >= FOC_FAULT_CONFIRM_TIME)
+    {
+        fault->state = FOC_FAULT_STATE_NONE;
+    }
+    else if (fault->state == FOC_FAULT_STATE_NONE && fault->retry != 0 && elapsed >= FOC_FAULT_RETRY_CLEAR)
+    {
+        fault->retry = 0;
+    }
+}
+
+void FOC_Fault_Report(const FOC_Fault_t *fault)
+{
+    const FOC_FaultRecord_t *rec;
+    uint16_t n = (fault->log_count < FOC_FAULT_LOG_SIZE) ? fault->log_count : FOC_FAULT_LOG_SIZE;
+    uint16_t k;
+    uint8_t i;
+
+    for (k = 0; k < n; k++)
+    {
+        rec = &fault->log[(fault->log_count - n + k) % FOC_FAULT_LOG_SIZE];
+        for (i = 0; i < FOC_FAULT_CAUSE_NUM; i++)
+        {
+            if ((rec->cause & (1u << i)) == 0)
+            {
+                continue;
+            }
+#ifndef FOC_HOST_BUILD
+            /* debug()使用DMA发送，等待上一行发送完成 */
+            while (huart1.gState != HAL_UART_STATE_READY)
+            {
+            }
+#endif
+            debug("fault %s tick:%lu cycle:%lu state:%u retry:%u\r\n",
+                  Fault_Name[i],
+                  (unsigned long)rec->tick,
+                  (unsigned long)rec->cycle,
+                  (unsigned)rec->state,
+                  (unsigned)fault->retry);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#include "foc_fieldweak.h"
+
+/* 整数平方根，逐位确定，循环次数固定 */
+static FOC_RAMFUNC uint32_t FieldWeak_Sqrt(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    uint8_t i;
+
+    for (i = 0; i < 16u; i++)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+void FOC_FieldWeak_Init(FOC_FieldWeak_t *fw)
+{
+    int32_t i_max = FOC_FLOAT_TO_Q15(FOC_FW_I_MAX - FOC_FW_I_MARGIN);
+    int32_t id_min = FOC_FLOAT_TO_Q15(FOC_FW_ID_MIN);
+
+    fw->enable = 0;
+    fw->modulation_ref = (uint16_t)(FOC_FW_MODULATION_REF * 32768.0f);
+    fw->modulation = 0;
+    fw->ki = (int32_t)(FOC_FW_KI / FOC_Q15_BASE * (float)(1 << FOC_PI_SHIFT));
+    fw->integral = 0;
+    fw->integral_min = ((id_min < -i_max) ? -i_max : id_min) << FOC_PI_SHIFT;
+    fw->i_max_sq = (uint32_t)(i_max * i_max);
+    fw->id_ref = 0;
+    fw->iq_max = (FOC_Q15_t)i_max;
+}
+
+/* 关闭时id积分清零，下一周期起不再注入 */
+void FOC_FieldWeak_Enable(FOC_FieldWeak_t *fw, uint8_t enable)
+{
+    fw->enable = enable;
+    fw->integral = 0;
+    fw->id_ref = 0;
+}
+
+/********************************************************************************
+ * 弱磁单次更新，每个PWM周期在FOC_CurrentLoop_Update之前调用
+ * 调制度取上一个周期的调制结果：id += Ki * (m_ref - m)，限制在[ID_MIN, 0]；
+ * 改写loop->i_ref.id，并按电流圆限幅loop->i_ref.iq
+ * （限幅直接作用在给定上，速度环下次执行时重新给出）
+ *********************************************************************************/
+FOC_RAMFUNC void FOC_FieldWeak_Update(FOC_FieldWeak_t *fw, FOC_CurrentLoop_t *loop)
+{
+    int32_t error;
+    uint32_t id_sq;
+    FOC_PROFILE_START(FOC_PROFILE_FIELDWEAK);
+
+    if (fw->enable)
+    {
+        fw->modulation = FOC_SVPWM_GetModulation(loop->pwm);
+        error = (int32_t)fw->modulation_ref - fw->modulation;
+        fw->integral += fw->ki * error;
+        if (fw->integral > 0)
+        {
+            fw->integral = 0;
+        }
+        else if (fw->integral < fw->integral_min)
+        {
+            fw->integral = fw->integral_min;
+        }
+        fw->id_ref = (FOC_Q15_t)(fw->integral >> FOC_PI_SHIFT);
+        id_sq = (uint32_t)((int32_t)fw->id_ref * fw->id_ref);
+        fw->iq_max = (FOC_Q15_t)FieldWeak_Sqrt((id_sq < fw->i_max_sq) ? (fw->i_max_sq - id_sq) : 0);
+        loop->i_ref.id = fw->id_ref;
+        if (loop->i_ref.iq > fw->iq_max)
+        {
+            loop->i_ref.iq = fw->iq_max;
+        }
+        else if (loop->i_ref.iq < -fw->iq_max)
+        {
+            loop->i_ref.iq = -fw->iq_max;
+        }
+    }
+    FOC_PROFILE_STOP(FOC_PROFILE_FIELDWEAK);
+}
@@ -0,0 +1,182 @@
+#include "foc_hall.h"
+
+static const uint8_t Hall_SectorTable[8] = FOC_HALL_SECTOR_TABLE;
+
+/********************************************************************************
+ * 霍尔初始化
+ * htim：霍尔传感器接口模式定时器，预分频FOC_HALL_TIM_PRESCALER
+ * period_ticks：一个PWM周期的定时器时钟计数（中心对齐为2*ARR）
+ *********************************************************************************/
+void FOC_Hall_Init(FOC_Hall_t *hall, TIM_HandleTypeDef *htim, uint32_t period_ticks)
+{
+    hall->htim = htim;
+    hall->pwm_ticks_q8 = (period_ticks << 8) / (FOC_HALL_TIM_PRESCALER + 1u);
+    hall->state = 0;
+    hall->sector = FOC_HALL_INVALID;
+    hall->dir = 0;
+    hall->speed_valid = 0;
+    hall->edge_angle = 0;
+    hall->angle_per_tick = 0;
+    hall->period = 0;
+    hall->speed = 0;
+    hall->edge_count = 0;
+    hall->edge_seen = 0;
+    hall->age = FOC_HALL_TIMEOUT;
+    hall->error_count = 0;
+    hall->angle = 0;
+}
+
+#ifndef FOC_HOST_BUILD
+static uint8_t Hall_ReadState(void)
+{
+    return (uint8_t)(HAL_GPIO_ReadPin(FOC_HALL_H1_PORT, FOC_HALL_H1_PIN)
+                     | (HAL_GPIO_ReadPin(FOC_HALL_H2_PORT, FOC_HALL_H2_PIN) << 1)
+                     | (HAL_GPIO_ReadPin(FOC_HALL_H3_PORT, FOC_HALL_H3_PIN) << 2));
+}
+#endif
+
+/* 上电时按当前霍尔状态确定扇区，第一个边沿之前角度取扇区中点 */
+void FOC_Hall_Start(FOC_Hall_t *hall)
+{
+#ifndef FOC_HOST_BUILD
+    hall->state = Hall_ReadState();
+    hall->sector = Hall_SectorTable[hall->state & 7u];
+    HAL_TIMEx_HallSensor_Start_IT(hall->htim);
+#else
+    (void)hall;
+#endif
+}
+
+/********************************************************************************
+ * 霍尔边沿处理，在定时器捕获中断中调用（与电流环中断同一抢占优先级，互不打断）
+ * state：边沿后的霍尔状态
+ * period：CCR1捕获的上一个扇区时间（定时器计数）
+ * 相邻扇区确定方向：正转进入扇区n的边沿在n*60°，反转在(n+1)*60°；
+ * 连续两个同向边沿之间的时间才是完整扇区，用于计算扇区内角速度
+ *********************************************************************************/
+void FOC_Hall_Edge(FOC_Hall_t *hall, uint8_t state, uint16_t period)
+{
+    uint8_t sector = Hall_SectorTable[state & 7u];
+    uint8_t step;
+    int8_t dir = 0;
+    FOC_PROFILE_START(FOC_PROFILE_HALL_EDGE);
+
+    hall->state = state;
+    hall->edge_count++;
+    if (sector == FOC_HALL_INVALID)
+    {
+        hall->error_count++;
+        hall->sector = FOC_HALL_INVALID;
+        hall->dir = 0;
+        hall->speed_valid = 0;
+        FOC_PROFILE_STOP(FOC_PROFILE_HALL_EDGE);
+        return;
+    }
+    if (hall->sector != FOC_HALL_INVALID)
+    {
+        step = (uint8_t)((sector + 6u - hall->sector) % 6u);
+        if (step == 1u)
+        {
+            dir = 1;
+        }
+        else if (step == 5u)
+        {
+            dir = -1;
+        }
+        else
+        {
+            hall->error_count++;
+        }
+    }
+
+    hall->edge_angle = ((uint32_t)FOC_HALL_ANGLE_OFFSET << 16) + (uint32_t)sector * FOC_HALL_SECTOR_ANGLE;
+    if (dir < 0)
+    {
+        hall->edge_angle += FOC_HALL_SECTOR_ANGLE;
+    }
+    if (dir != 0 && dir == hall->dir && period != 0)
+    {
+        hall->period = period;
+        hall->angle_per_tick = FOC_HALL_SECTOR_ANGLE / period;
+        hall->speed = (int32_t)(((uint64_t)hall->angle_per_tick * hall->pwm_ticks_q8) >> 8);
+        if (dir < 0)
+        {
+            hall->speed = -hall->speed;
+        }
+        hall->speed_valid = 1;
+    }
+    else
+    {
+        hall->speed_valid = 0;
+    }
+    hall->dir = dir;
+    hall->sector = sector;
+    FOC_PROFILE_STOP(FOC_PROFILE_HALL_EDGE);
+}
+
+#ifndef FOC_HOST_BUILD
+/* 定时器CC1捕获中断：读取霍尔状态与扇区时间 */
+void FOC_Hall_Capture(FOC_Hall_t *hall)
+{
+    FOC_Hall_Edge(hall, Hall_ReadState(), (uint16_t)__HAL_TIM_GET_COMPARE(hall->htim, TIM_CHANNEL_1));
+}
+#endif
+
+/********************************************************************************
+ * 霍尔角度插值，每个PWM周期在电流环中断中调用一次
+ * elapsed：电流采样时刻距最近一个霍尔边沿的时间（定时器计数）
+ * 角度 = 边沿角度 ± 扇区内角速度 * elapsed，不超出当前扇区；
+ * 速度无效（启动、换向、超时静止）时取扇区中点，误差不超过30°
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Angle_t FOC_Hall_Update(FOC_Hall_t *hall, uint32_t elapsed)
+{
+    uint32_t angle, delta;
+
+    if (hall->edge_count != hall->edge_seen)
+    {
+        hall->edge_seen = hall->edge_count;
+        hall->age = 0;
+    }
+    else if (hall->age < FOC_HALL_TIMEOUT)
+    {
+        hall->age++;
+    }
+    else
+    {
+        hall->dir = 0;
+        hall->speed_valid = 0;
+    }
+    if (hall->sector == FOC_HALL_INVALID)
+    {
+        return hall->angle;
+    }
+
+    if (hall->speed_valid)
+    {
+        delta = (elapsed >= hall->period) ? (FOC_HALL_SECTOR_ANGLE - 1u) : hall->angle_per_tick * elapsed;
+        angle = (hall->dir > 0) ? (hall->edge_angle + delta) : (hall->edge_angle - delta);
+    }
+    else
+    {
+        hall->speed = 0;
+        angle = ((uint32_t)FOC_HALL_ANGLE_OFFSET << 16) + (uint32_t)hall->sector * FOC_HALL_SECTOR_ANGLE
+                + FOC_HALL_SECTOR_ANGLE / 2u;
+    }
+    hall->angle = (FOC_Angle_t)(angle >> (32 - FOC_ANGLE_BITS));
+    return hall->angle;
+}
+
+/* delay：读取时刻滞后于电流采样时刻的定时器时钟计数（未分频） */
+FOC_RAMFUNC FOC_Angle_t FOC_Hall_Read(FOC_Hall_t *hall, uint32_t delay)
+{
+    uint32_t elapsed = __HAL_TIM_GET_COUNTER(hall->htim);
+
+    delay /= FOC_HALL_TIM_PRESCALER + 1u;
+    return FOC_Hall_Update(hall, (elapsed > delay) ? (elapsed - delay) : 0);
+}
+
+/* 电角速度（rad/s），ts为PWM周期 */
+float FOC_Hall_GetSpeed(const FOC_Hall_t *hall, float ts)
+{
+    return (float)hall->speed * (6.283185307f / 4294967296.0f) / ts;
+}
@@ -0,0 +1,254 @@
+#include "foc_ident.h"
+
+/********************************************************************************
+ * 辨识初始化，ts为PWM周期（s）
+ * 各步骤时间换算为PWM周期数，电流、电压换算为Q15
+ *********************************************************************************/
+void FOC_Ident_Init(FOC_Ident_t *ident, float ts)
+{
+    ident->state = FOC_IDENT_IDLE;
+    ident->ts = ts;
+    ident->n_align = (uint32_t)(FOC_IDENT_ALIGN_TIME / ts);
+    ident->n_settle = (uint32_t)(FOC_IDENT_SETTLE_TIME / ts);
+    ident->n_measure = (uint32_t)(FOC_IDENT_MEASURE_TIME / ts);
+    ident->n_ramp = (uint32_t)(FOC_IDENT_SPIN_RAMP_TIME / ts);
+    ident->current = FOC_FLOAT_TO_Q15(FOC_IDENT_CURRENT);
+    ident->hf_voltage = FOC_FLOAT_TO_Q15(FOC_IDENT_HF_VOLTAGE);
+    ident->spin_current = FOC_FLOAT_TO_Q15(FOC_IDENT_SPIN_CURRENT);
+    ident->spin_step = (uint32_t)(FOC_IDENT_SPIN_SPEED * ts / _2PI * 4294967296.0f);
+    ident->rs = 0.0f;
+    ident->ld = 0.0f;
+    ident->lq = 0.0f;
+    ident->flux = 0.0f;
+}
+
+static void Ident_Next(FOC_Ident_t *ident, uint8_t state)
+{
+    ident->state = state;
+    ident->count = 0;
+    ident->sum_vd = 0;
+    ident->sum_vq = 0;
+    ident->sum_id = 0;
+    ident->sum_iq = 0;
+    ident->n = 0;
+    ident->sum_di = 0;
+    ident->n_di = 0;
+}
+
+/* 从电角度0开始，依次执行全部步骤 */
+void FOC_Ident_Start(FOC_Ident_t *ident)
+{
+    ident->theta = 0;
+    ident->angle = 0;
+    Ident_Next(ident, FOC_IDENT_ALIGN);
+}
+
+FOC_RAMFUNC uint8_t FOC_Ident_Busy(const FOC_Ident_t *ident)
+{
+    return (uint8_t)(ident->state >= FOC_IDENT_ALIGN && ident->state <= FOC_IDENT_SPIN);
+}
+
+/* 稳定时间之后累加dq电压、电流，测量时间到返回1 */
+static uint8_t Ident_Measure(FOC_Ident_t *ident, const FOC_CurrentLoop_t *loop, uint32_t settle)
+{
+    if (ident->count > settle)
+    {
+        ident->sum_vd += loop->v_dq.id;
+        ident->sum_vq += loop->v_dq.iq;
+        ident->sum_id += loop->i_dq.id;
+        ident->sum_iq += loop->i_dq.iq;
+        ident->n++;
+    }
+    return (uint8_t)(ident->n >= ident->n_measure);
+}
+
+/* 方波注入电压：相位n = count % (2 * HALF)，前半周期 +Uh，后半周期 -Uh */
+static FOC_Q15_t Ident_Inject(const FOC_Ident_t *ident)
+{
+    return ((ident->count % (2u * FOC_IDENT_HF_HALF)) < FOC_IDENT_HF_HALF) ? ident->hf_voltage : (FOC_Q15_t)-ident->hf_voltage;
+}
+
+/********************************************************************************
+ * 注入电流变化量，i为本周期采样的电流
+ * 本周期计算的电压在采样之后才生效，第1 ~ HALF个采样之间的电压全部为 +Uh，
+ * 取这一段的电流变化量（HALF - 1个PWM周期），-Uh半周期同理
+ *********************************************************************************/
+static void Ident_InjectMeasure(FOC_Ident_t *ident, FOC_Q15_t i)
+{
+    uint32_t n = ident->count % (2u * FOC_IDENT_HF_HALF);
+
+    if (ident->count <= ident->n_settle / 4u)
+    {
+        return;
+    }
+    if (n == 1u || n == FOC_IDENT_HF_HALF + 1u)
+    {
+        ident->i_mark = i;
+    }
+    else if (n == FOC_IDENT_HF_HALF)
+    {
+        ident->sum_di += i - ident->i_mark;
+        ident->n_di++;
+    }
+    else if (n == 0u && ident->n_di != 0u)
+    {
+        ident->sum_di += ident->i_mark - i;
+        ident->n_di++;
+    }
+}
+
+/* 电感 = Uh * (HALF - 1) * Ts / 平均电流变化量，电阻在正负半周期内抵消 */
+static float Ident_Inductance(const FOC_Ident_t *ident)
+{
+    if (ident->sum_di <= 0)
+    {
+        return 0.0f;
+    }
+    return FOC_IDENT_HF_VOLTAGE * (float)(FOC_IDENT_HF_HALF - 1u) * ident->ts
+           / FOC_Q15_TO_FLOAT((float)ident->sum_di / (float)ident->n_di);
+}
+
+/********************************************************************************
+ * I/f旋转结束时按稳态平均值计算磁链
+ * 旋转坐标系（d轴为电流方向）内 λ = (U - Rs * I) / (jω)，记为 a + jb；
+ * 转子滞后电流矢量δ，转子坐标系内 λ * e^(jδ) = ψ + Ld * I * cosδ + j * Lq * I * sinδ，
+ * 虚部得 δ = atan2(-b, a - Lq * I)，实部得 ψ
+ *********************************************************************************/
+static float Ident_Flux(const FOC_Ident_t *ident)
+{
+    float n = (float)ident->n;
+    float vd = FOC_Q15_TO_FLOAT(ident->sum_vd / n);
+    float vq = FOC_Q15_TO_FLOAT(ident->sum_vq / n);
+    float id = FOC_Q15_TO_FLOAT(ident->sum_id / n);
+    float iq = FOC_Q15_TO_FLOAT(ident->sum_iq / n);
+    float w = (float)ident->spin_step * _2PI / 4294967296.0f / ident->ts;
+    float a = (vq - ident->rs * iq) / w;
+    float b = -(vd - ident->rs * id) / w;
+    float delta = atan2f(-b, a - ident->lq * id);
+
+    return a * cosf(delta) - b * sinf(delta) - ident->ld * id * cosf(delta);
+}
+
+/* 按辨识结果计算电流环PI增益，结果不合理时进入故障状态 */
+static void Ident_Finish(FOC_Ident_t *ident)
+{
+    if (ident->rs <= 0.0f || ident->ld <= 0.0f || ident->lq <= 0.0f || ident->flux <= 0.0f)
+    {
+        ident->state = FOC_IDENT_FAULT;
+        return;
+    }
+    ident->kp_d = ident->ld * FOC_IDENT_CURRENT_BW;
+    ident->kp_q = ident->lq * FOC_IDENT_CURRENT_BW;
+    ident->ki_d = ident->rs * FOC_IDENT_CURRENT_BW * ident->ts;
+    ident->ki_q = ident->ki_d;
+    ident->state = FOC_IDENT_DONE;
+}
+
+/********************************************************************************
+ * 辨识单次更新，在电流环中断中代替FOC_CurrentLoop_Update，每个PWM周期调用一次
+ * 直流与旋转步骤由电流环调节电流，注入步骤由电压方式直接输出；
+ * 每一步结束时计算该步骤的结果，全部完成后状态为FOC_IDENT_DONE（或FOC_IDENT_FAULT），输出零电压
+ *********************************************************************************/
+const FOC_PWMCounter_t *FOC_Ident_Update(FOC_Ident_t *ident, FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw)
+{
+    const FOC_PWMCounter_t *counter;
+    uint32_t step;
+    float n;
+
+    ident->count++;
+    switch (ident->state)
+    {
+    case FOC_IDENT_ALIGN:
+        loop->i_ref.id = ident->current;
+        loop->i_ref.iq = 0;
+        counter = FOC_CurrentLoop_Update(loop, i_uvw, ident->angle);
+        if (ident->count >= ident->n_align)
+        {
+            Ident_Next(ident, FOC_IDENT_RS_LOW);
+        }
+        break;
+
+    case FOC_IDENT_RS_LOW:
+        loop->i_ref.id = (FOC_Q15_t)(ident->current >> 1);
+        counter = FOC_CurrentLoop_Update(loop, i_uvw, ident->angle);
+        if (Ident_Measure(ident, loop, ident->n_settle))
+        {
+            n = (float)ident->n;
+            ident->v_low = FOC_Q15_TO_FLOAT(ident->sum_vd / n);
+            ident->i_low = FOC_Q15_TO_FLOAT(ident->sum_id / n);
+            Ident_Next(ident, FOC_IDENT_RS_HIGH);
+        }
+        break;
+
+    case FOC_IDENT_RS_HIGH:
+        loop->i_ref.id = ident->current;
+        counter = FOC_CurrentLoop_Update(loop, i_uvw, ident->angle);
+        if (Ident_Measure(ident, loop, ident->n_settle))
+        {
+            n = (float)ident->n;
+            ident->rs = (FOC_Q15_TO_FLOAT(ident->sum_vd / n) - ident->v_low)
+                        / (FOC_Q15_TO_FLOAT(ident->sum_id / n) - ident->i_low);
+            ident->v_hold.id = (FOC_Q15_t)(ident->sum_vd / (int32_t)ident->n);
+            ident->v_hold.iq = (FOC_Q15_t)(ident->sum_vq / (int32_t)ident->n);
+            Ident_Next(ident, FOC_IDENT_HF_D);
+        }
+        break;
+
+    case FOC_IDENT_HF_D:
+        loop->v_dq.id = FOC_Sat_Q15((FOC_Q31_t)ident->v_hold.id + Ident_Inject(ident));
+        loop->v_dq.iq = ident->v_hold.iq;
+        counter = FOC_CurrentLoop_VoltageUpdate(loop, i_uvw, ident->angle);
+        Ident_InjectMeasure(ident, loop->i_dq.id);
+        if (ident->count >= ident->n_settle / 4u + ident->n_measure)
+        {
+            ident->ld = Ident_Inductance(ident);
+            Ident_Next(ident, FOC_IDENT_HF_Q);
+        }
+        break;
+
+    case FOC_IDENT_HF_Q:
+        loop->v_dq.id = ident->v_hold.id;
+        loop->v_dq.iq = FOC_Sat_Q15((FOC_Q31_t)ident->v_hold.iq + Ident_Inject(ident));
+        counter = FOC_CurrentLoop_VoltageUpdate(loop, i_uvw, ident->angle);
+        Ident_InjectMeasure(ident, loop->i_dq.iq);
+        if (ident->count >= ident->n_settle / 4u + ident->n_measure)
+        {
+            ident->lq = Ident_Inductance(ident);
+            Ident_Next(ident, FOC_IDENT_SPIN);
+        }
+        break;
+
+    case FOC_IDENT_SPIN:
+        /* 转速线性增加到FOC_IDENT_SPIN_SPEED后保持 */
+        step = (ident->count >= ident->n_ramp) ? ident->spin_step
+               : (uint32_t)(((uint64_t)ident->spin_step * ident->count) / ident->n_ramp);
+        ident->theta += step;
+        ident->angle = (FOC_Angle_t)(ident->theta >> (32 - FOC_ANGLE_BITS));
+        loop->i_ref.id = ident->spin_current;
+        loop->i_ref.iq = 0;
+        counter = FOC_CurrentLoop_Update(loop, i_uvw, ident->angle);
+        if (Ident_Measure(ident, loop, ident->n_ramp + ident->n_settle))
+        {
+            ident->flux = Ident_Flux(ident);
+            Ident_Finish(ident);
+        }
+        break;
+
+    default:
+        loop->v_dq.id = 0;
+        loop->v_dq.iq = 0;
+        counter = FOC_CurrentLoop_VoltageUpdate(loop, i_uvw, ident->angle);
+        break;
+    }
+    return counter;
+}
+
+/* 辨识结果写入电流环与观测器，电流给定清零（转子随后自由减速） */
+void FOC_Ident_Apply(const FOC_Ident_t *ident, FOC_CurrentLoop_t *loop, FOC_Observer_t *obs)
+{
+    FOC_PI_Init(&loop->pi_d, ident->kp_d, ident->ki_d, FOC_SVPWM_GetVoltageLimit_Q15(loop->pwm));
+    FOC_PI_Init(&loop->pi_q, ident->kp_q, ident->ki_q, FOC_SVPWM_GetVoltageLimit_Q15(loop->pwm));
+    loop->i_ref.id = 0;
+    loop->i_ref.iq = 0;
+    FOC_Observer_Init(obs, ident->rs, ident->lq, ident->ts);
+}
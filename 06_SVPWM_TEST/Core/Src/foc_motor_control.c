@@ -1,8 +1,5 @@
 #include "foc_motor_control.h"
 
-float arm_sin(float x);
-float arm_cos(float x);
-
 /********************************************************************************
  * Clarke变换（3相->2相）
  *********************************************************************************/
@@ -31,11 +28,12 @@ FOC_Alpha_Beta_t FOC_Clarke_Transform(const FOC_U_V_W_t *i_uvw)
 /********************************************************************************
  * Park变换（静止坐标系->旋转坐标系）
  *********************************************************************************/
-FOC_D_Q_t FOC_Park_Transform(const FOC_Alpha_Beta_t *i_AlphaBeta, const float ElectricalAngle)
+FOC_D_Q_t FOC_Park_Transform(const FOC_Alpha_Beta_t *i_AlphaBeta, const FOC_Angle_t ElectricalAngle)
 {
     FOC_D_Q_t i_DQ;
-    float sinTheta = arm_sin(ElectricalAngle);
-    float cosTheta = arm_cos(ElectricalAngle);
+    float sinTheta, cosTheta;
+
+    FOC_SinCos(ElectricalAngle, &sinTheta, &cosTheta);
 
     /**
      * | Id | = | cosθ    sinθ | | α |
@@ -50,12 +48,12 @@ FOC_D_Q_t FOC_Park_Transform(const FOC_Alpha_Beta_t *i_AlphaBeta, const float El
 /********************************************************************************
  * Park逆变换（旋转坐标系-> α β 坐标系）
  *********************************************************************************/
-FOC_Alpha_Beta_t FOC_Inverse_Park_Transform(const FOC_D_Q_t *i_DQ, const float ElectricalAngle)
+FOC_Alpha_Beta_t FOC_Inverse_Park_Transform(const FOC_D_Q_t *i_DQ, const FOC_Angle_t ElectricalAngle)
 {
     FOC_Alpha_Beta_t i_AlphaBeta;
+    float sinTheta, cosTheta;
 
-    float cosTheta = arm_cos(ElectricalAngle);
-    float sinTheta = arm_sin(ElectricalAngle);
+    FOC_SinCos(ElectricalAngle, &sinTheta, &cosTheta);
     /**
      * | Iα | = | cosθ   -sinθ | | Id |
      * | Iβ | = | sinθ    cosθ | | Iq |
@@ -85,39 +83,102 @@ FOC_U_V_W_t FOC_Inverse_Clarke_Transform(const FOC_Alpha_Beta_t *i_AlphaBeta)
 }
 
 /********************************************************************************
- * 电角度限幅（0 ~ 2π）
+ * Clarke变换（Q15定点）
  *********************************************************************************/
-void Limit_Angle(float *ElectricalAngle)
+FOC_RAMFUNC FOC_Alpha_Beta_Q15_t FOC_Clarke_Transform_Q15(const FOC_U_V_W_Q15_t *i_uvw)
 {
-    while (*ElectricalAngle > _2PI || *ElectricalAngle < 0)
-    {
-        if (*ElectricalAngle > _2PI)
-        {
-            *ElectricalAngle -= _2PI;
-        }
-        else if (*ElectricalAngle < 0)
-        {
-            *ElectricalAngle += _2PI;
-        }
-    }
+    FOC_Alpha_Beta_Q15_t i_AlphaBeta;
+
+    /* β = (u + 2v) / √3，1/√3 的Q15值为18919 */
+    i_AlphaBeta.alpha = i_uvw->iu;
+    i_AlphaBeta.beta = FOC_Sat_Q15(((FOC_Q31_t)i_uvw->iu + 2 * (FOC_Q31_t)i_uvw->iv) * 18919 >> 15);
+
+    return i_AlphaBeta;
+}
+
+/********************************************************************************
+ * Park变换（Q15定点）
+ *********************************************************************************/
+FOC_RAMFUNC FOC_D_Q_Q15_t FOC_Park_Transform_Q15(const FOC_Alpha_Beta_Q15_t *i_AlphaBeta, FOC_Angle_t ElectricalAngle)
+{
+    FOC_D_Q_Q15_t i_DQ;
+    FOC_Q15_t sinTheta, cosTheta;
+
+    FOC_SinCos_Q15(ElectricalAngle, &sinTheta, &cosTheta);
+
+    /* Q15 * Q15 = Q30，累加在Q31中完成，右移15位回到Q15 */
+    i_DQ.id = FOC_Sat_Q15(((FOC_Q31_t)cosTheta * i_AlphaBeta->alpha + (FOC_Q31_t)sinTheta * i_AlphaBeta->beta) >> 15);
+    i_DQ.iq = FOC_Sat_Q15(((FOC_Q31_t)cosTheta * i_AlphaBeta->beta - (FOC_Q31_t)sinTheta * i_AlphaBeta->alpha) >> 15);
+
+    return i_DQ;
+}
+
+/********************************************************************************
+ * Park逆变换（Q15定点）
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Alpha_Beta_Q15_t FOC_Inverse_Park_Transform_Q15(const FOC_D_Q_Q15_t *i_DQ, FOC_Angle_t ElectricalAngle)
+{
+    FOC_Alpha_Beta_Q15_t i_AlphaBeta;
+    FOC_Q15_t sinTheta, cosTheta;
+
+    FOC_SinCos_Q15(ElectricalAngle, &sinTheta, &cosTheta);
+
+    i_AlphaBeta.alpha = FOC_Sat_Q15(((FOC_Q31_t)cosTheta * i_DQ->id - (FOC_Q31_t)sinTheta * i_DQ->iq) >> 15);
+    i_AlphaBeta.beta = FOC_Sat_Q15(((FOC_Q31_t)sinTheta * i_DQ->id + (FOC_Q31_t)cosTheta * i_DQ->iq) >> 15);
+
+    return i_AlphaBeta;
+}
+
+/********************************************************************************
+ * Clarke逆变换（Q15定点）
+ *********************************************************************************/
+FOC_U_V_W_Q15_t FOC_Inverse_Clarke_Transform_Q15(const FOC_Alpha_Beta_Q15_t *i_AlphaBeta)
+{
+    FOC_U_V_W_Q15_t i_UVW;
+    /* 1/2 的Q15值为16384，√3/2 的Q15值为28378 */
+    FOC_Q31_t alpha_half = (FOC_Q31_t)i_AlphaBeta->alpha * 16384;
+    FOC_Q31_t beta_sqrt3_half = (FOC_Q31_t)i_AlphaBeta->beta * 28378;
+
+    i_UVW.iu = i_AlphaBeta->alpha;
+    i_UVW.iv = FOC_Sat_Q15((-alpha_half + beta_sqrt3_half) >> 15);
+    i_UVW.iw = FOC_Sat_Q15((-alpha_half - beta_sqrt3_half) >> 15);
+
+    return i_UVW;
 }
 
-static float test_ElectricalAngle = 0;
-FOC_U_V_W_t I_uvw;
-FOC_Alpha_Beta_t I_AlphaBeta;
-FOC_D_Q_t I_dq;
+/* 调试函数共用的测试波形，只在主循环中调用 */
+static FOC_Angle_t test_ElectricalAngle = 0;
+static const float test_AngleStep = 0.1f; /* 每次调试递增的电角度（弧度） */
+static FOC_U_V_W_t I_uvw;
+static FOC_Alpha_Beta_t I_AlphaBeta;
+static FOC_D_Q_t I_dq;
 
 void FOC_ClarkePark_Debug(void)
 {
-    test_ElectricalAngle += 0.1f;
-    Limit_Angle(&test_ElectricalAngle); /* 模拟生成三相正弦波 */
-    I_uvw.iu = arm_sin(test_ElectricalAngle);
-    I_uvw.iv = arm_sin(test_ElectricalAngle + _PI_3 * 2.0f);
-    I_uvw.iw = arm_sin(test_ElectricalAngle + _PI_3 * 2.0f + _PI_3 * 2.0f);
+    float cosTheta;
+
+    test_ElectricalAngle += FOC_Angle_FromRad(test_AngleStep); /* 模拟生成三相正弦波 */
+    FOC_SinCos(test_ElectricalAngle, &I_uvw.iu, &cosTheta);
+    FOC_SinCos((FOC_Angle_t)(test_ElectricalAngle + FOC_ANGLE_2PI_3), &I_uvw.iv, &cosTheta);
+    FOC_SinCos((FOC_Angle_t)(test_ElectricalAngle + FOC_ANGLE_2PI_3 + FOC_ANGLE_2PI_3), &I_uvw.iw, &cosTheta);
+#if FOC_USE_Q15
+    {
+        FOC_U_V_W_Q15_t uvw_q15 = {FOC_FLOAT_TO_Q15(I_uvw.iu), FOC_FLOAT_TO_Q15(I_uvw.iv), FOC_FLOAT_TO_Q15(I_uvw.iw)};
+        FOC_Alpha_Beta_Q15_t alphabeta_q15 = FOC_Clarke_Transform_Q15(&uvw_q15);
+        FOC_D_Q_Q15_t dq_q15;
+
+        I_AlphaBeta.alpha = FOC_Q15_TO_FLOAT(alphabeta_q15.alpha);
+        I_AlphaBeta.beta = FOC_Q15_TO_FLOAT(alphabeta_q15.beta);
+        dq_q15 = FOC_Park_Transform_Q15(&alphabeta_q15, FOC_Atan2_Q15(alphabeta_q15.beta, alphabeta_q15.alpha));
+        I_dq.id = FOC_Q15_TO_FLOAT(dq_q15.id);
+        I_dq.iq = FOC_Q15_TO_FLOAT(dq_q15.iq);
+    }
+#else
     I_AlphaBeta = FOC_Clarke_Transform(&I_uvw);
-    I_dq = FOC_Park_Transform(&I_AlphaBeta, atan2f(I_AlphaBeta.beta, I_AlphaBeta.alpha));
+    I_dq = FOC_Park_Transform(&I_AlphaBeta, FOC_Atan2_Q15(FOC_FLOAT_TO_Q15(I_AlphaBeta.beta), FOC_FLOAT_TO_Q15(I_AlphaBeta.alpha)));
+#endif
     debug("%f,%f,%f,%f,%f,%f,%f,%f\r\n",
-          test_ElectricalAngle,
+          FOC_Angle_ToRad(test_ElectricalAngle),
           I_uvw.iu,
           I_uvw.iv,
           I_uvw.iw,
@@ -129,14 +190,27 @@ void FOC_ClarkePark_Debug(void)
 
 void FOC_InverseParkInverseClarke_Debug(void)
 {
-    test_ElectricalAngle += 0.1f;
+    test_ElectricalAngle += FOC_Angle_FromRad(test_AngleStep);
     I_dq.id = 0.0;
     I_dq.iq = 0.5;
-    Limit_Angle(&test_ElectricalAngle);
+#if FOC_USE_Q15
+    {
+        FOC_D_Q_Q15_t dq_q15 = {FOC_FLOAT_TO_Q15(I_dq.id), FOC_FLOAT_TO_Q15(I_dq.iq)};
+        FOC_Alpha_Beta_Q15_t alphabeta_q15 = FOC_Inverse_Park_Transform_Q15(&dq_q15, test_ElectricalAngle);
+        FOC_U_V_W_Q15_t uvw_q15 = FOC_Inverse_Clarke_Transform_Q15(&alphabeta_q15);
+
+        I_AlphaBeta.alpha = FOC_Q15_TO_FLOAT(alphabeta_q15.alpha);
+        I_AlphaBeta.beta = FOC_Q15_TO_FLOAT(alphabeta_q15.beta);
+        I_uvw.iu = FOC_Q15_TO_FLOAT(uvw_q15.iu);
+        I_uvw.iv = FOC_Q15_TO_FLOAT(uvw_q15.iv);
+        I_uvw.iw = FOC_Q15_TO_FLOAT(uvw_q15.iw);
+    }
+#else
     I_AlphaBeta = FOC_Inverse_Park_Transform(&I_dq, test_ElectricalAngle); /* 帕克逆变换 */
     I_uvw = FOC_Inverse_Clarke_Transform(&I_AlphaBeta);                    /* 克拉克逆变换 */
+#endif
     debug("%f,%f,%f,%f,%f,%f,%f,%f\r\n",
-          test_ElectricalAngle,
+          FOC_Angle_ToRad(test_ElectricalAngle),
           I_uvw.iu,
           I_uvw.iv,
           I_uvw.iw,
@@ -220,351 +294,1097 @@ uint8_t FOC_SVPWM_GetSector(const FOC_Alpha_Beta_t *I_AlphaBeta)
     return sector;
 }
 
-const float sinVector[7] =
+/********************************************************************************
+ * 扇区判断与矢量作用时间（Q15定点）
+ * alpha/beta为Q15（1.0对应实际母线电压），与SVPWM_MinMax的输入相同，由外层按pwm->bus换算；
+ * 以Ts = 1、Udc = 1代入：
+ *   X = √3 * Ubeta，Y = 3/2 * Ualpha + √3/2 * Ubeta，Z = -3/2 * Ualpha + √3/2 * Ubeta
+ * 各扇区的Tx、Ty取其中两项（或其相反数），只有乘法和移位
+ *********************************************************************************/
+#if FOC_SVPWM_MODE != FOC_SVPWM_MODE_MINMAX
+static FOC_RAMFUNC uint8_t SVPWM_Sector(int32_t alpha, int32_t beta)
+{
+    uint8_t sector = 0;
+
+    if (beta > 0)
     {
-        0,
-        1.5,
-        1.5,
-        0,
-        -1.5,
-        -1.5,
-        0,
-};
-const float cosVector[7] =
-    {
-        SQRT_3,
-        SQRT_3_DIV_2,
-        -SQRT_3_DIV_2,
-        -SQRT_3,
-        -SQRT_3_DIV_2,
-        SQRT_3_DIV_2,
-        SQRT_3,
-};
-FOC_VectorTime_t FOC_SVPWM_GetVectorTime(uint8_t sector, FOC_Alpha_Beta_t *I_AlphaBeta)
+        sector = 1;
+    }
+    if (28378 * alpha - (beta << 14) > 0) /* √3/2 * alpha - 1/2 * beta */
+    {
+        sector += 2;
+    }
+    if (-28378 * alpha - (beta << 14) > 0) /* -√3/2 * alpha - 1/2 * beta */
+    {
+        sector += 4;
+    }
+    return sector;
+}
+#endif
+
+static FOC_RAMFUNC FOC_VectorTime_t SVPWM_VectorTime(FOC_SVPWM_t *pwm, uint8_t sector, int32_t alpha, int32_t beta)
 {
     FOC_VectorTime_t t_VectorTime;
-    float Tx, Ty, f_temp;
-    const float Ts = 1.0f;
-    const float TsDivUdc = Ts / UDC;
-    float Ualpha = I_AlphaBeta->alpha;
-    float Ubeta = I_AlphaBeta->beta;
+    int32_t x, y, z, a, b, tx, ty, t_sum;
+
+    a = (alpha * 3) >> 1;           /* 3/2 * alpha */
+    b = (28378 * beta) >> 15;       /* √3/2 * beta */
+    x = (56756 * beta) >> 15;       /* √3 * beta */
+    y = a + b;
+    z = b - a;
 
     switch (sector)
     {
     case 1:
-        Tx = (-1.5f * Ualpha + SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
-        Ty = (1.5f * Ualpha + SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
+        tx = z;
+        ty = y;
         break;
 
     case 2:
-        Tx = (1.5f * Ualpha + SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
-        Ty = (-SQRT_3 * Ubeta) * TsDivUdc;
+        tx = y;
+        ty = -x;
         break;
 
     case 3:
-        Tx = (1.5f * Ualpha - SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
-        Ty = (SQRT_3 * Ubeta) * TsDivUdc;
+        tx = -z;
+        ty = x;
         break;
 
     case 4:
-        Tx = (-SQRT_3 * Ubeta) * TsDivUdc;
-        Ty = (-1.5f * Ualpha + SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
+        tx = -x;
+        ty = z;
         break;
 
     case 5:
-        Tx = SQRT_3 * Ubeta * TsDivUdc;
-        Ty = (-1.5f * Ualpha - SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
+        tx = x;
+        ty = -y;
         break;
 
     default:
-        Tx = (-1.5f * Ualpha - SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
-        Ty = (1.5f * Ualpha - SQRT_3_DIV_2 * Ubeta) * TsDivUdc;
+        tx = -y;
+        ty = -z;
         break;
     }
-    f_temp = Tx + Ty;
-    if (f_temp > Ts)
+    t_sum = tx + ty;
+    pwm->time_sum = t_sum;
+    /* 超出可用六边形时按比例缩小到六边形上，零矢量保留比较值限幅所需的最短时间 */
+    if (t_sum > pwm->config.span_max)
     {
-        Tx /= f_temp;
-        Ty /= f_temp;
+        tx = (int32_t)(((int64_t)tx * pwm->config.span_max) / t_sum);
+        ty = pwm->config.span_max - tx;
+        t_sum = pwm->config.span_max;
     }
-    t_VectorTime.t0 = (Ts - (Tx + Ty)) / 4.0f;
-    t_VectorTime.t1 = Tx / 2.0f + t_VectorTime.t0;
-    t_VectorTime.t2 = Ty / 2.0f + t_VectorTime.t1;
+    t_VectorTime.t0 = (uint16_t)((32768 - t_sum) >> 2);
+    t_VectorTime.t1 = (uint16_t)((tx >> 1) + t_VectorTime.t0);
+    t_VectorTime.t2 = (uint16_t)((ty >> 1) + t_VectorTime.t1);
 
     return t_VectorTime;
 }
 
-FOC_PWMCounter_t FOC_SVPWM_GetPWMCounter(uint8_t sector, const FOC_VectorTime_t *t_VectorTime)
+/* 浮点电压（V）换算为调制器输入的Q15（1.0对应实际母线电压），超过母线电压的分量饱和；只供浮点接口使用 */
+static int32_t SVPWM_VoltToQ15(const FOC_SVPWM_t *pwm, float v)
+{
+    return FOC_Sat_Q15((int32_t)(v * ((float)pwm->bus.udc_inv * (2.0f / FOC_Q15_BASE))));
+}
+
+FOC_VectorTime_t FOC_SVPWM_GetVectorTime(FOC_SVPWM_t *pwm, uint8_t sector, FOC_Alpha_Beta_t *I_AlphaBeta)
+{
+    return SVPWM_VectorTime(pwm, sector, SVPWM_VoltToQ15(pwm, I_AlphaBeta->alpha), SVPWM_VoltToQ15(pwm, I_AlphaBeta->beta));
+}
+
+/********************************************************************************
+ * 死区时间（换算为定时器计数值）
+ * BDTR.DTG编码：
+ *   DTG[7]   = 0   : DT = DTG[6:0] * Tdts
+ *   DTG[7:6] = 10  : DT = (64 + DTG[5:0]) * 2 * Tdts
+ *   DTG[7:5] = 110 : DT = (32 + DTG[4:0]) * 8 * Tdts
+ *   DTG[7:5] = 111 : DT = (32 + DTG[4:0]) * 16 * Tdts
+ * Tdts由CR1.CKD决定，计数器时钟再经过PSC分频
+ *********************************************************************************/
+uint16_t FOC_SVPWM_GetDeadTimeTicks(const TIM_HandleTypeDef *htim)
+{
+    uint32_t dtg = htim->Instance->BDTR & TIM_BDTR_DTG;
+    uint32_t ckd = (htim->Instance->CR1 & TIM_CR1_CKD) >> TIM_CR1_CKD_Pos;
+    uint32_t dt;
+
+    if ((dtg & 0x80u) == 0)
+    {
+        dt = dtg;
+    }
+    else if ((dtg & 0xC0u) == 0x80u)
+    {
+        dt = (64u + (dtg & 0x3Fu)) * 2u;
+    }
+    else if ((dtg & 0xE0u) == 0xC0u)
+    {
+        dt = (32u + (dtg & 0x1Fu)) * 8u;
+    }
+    else
+    {
+        dt = (32u + (dtg & 0x1Fu)) * 16u;
+    }
+    dt <<= ckd; /* Tdts = 1/2/4个内部时钟 */
+
+    return (uint16_t)((dt + htim->Init.Prescaler) / (htim->Init.Prescaler + 1u));
+}
+
+/********************************************************************************
+ * SVPWM初始化：缓存定时器周期与比较值限幅
+ * 中心对齐模式下，上管导通 2*CCR 个计数，下管导通 2*(ARR-CCR) 个计数，
+ * 各自再减去死区时间，比较值限幅保证上下管导通时间都不小于FOC_PWM_MIN_PULSE；
+ * 限幅后可输出的线电压最大为 Udc * (compare_max - compare_min) / ARR，
+ * 调制器以此为六边形边界按比例缩小，避免单相被限幅造成的波形畸变；
+ * 每个逆变器（定时器）一个调制器，过调制与DPWM方式取编译期默认值，母线电压取额定值
+ *********************************************************************************/
+void FOC_SVPWM_Init(FOC_SVPWM_t *pwm, TIM_HandleTypeDef *htim)
+{
+    uint32_t limit;
+
+    pwm->htim = htim;
+    pwm->overmod = FOC_OVERMOD_MODE;
+    pwm->dpwm = FOC_DPWM_MODE;
+    pwm->time_sum = 0;
+    pwm->config.period = (uint16_t)htim->Init.Period;
+    pwm->config.deadtime = FOC_SVPWM_GetDeadTimeTicks(htim);
+    limit = (pwm->config.deadtime + FOC_PWM_MIN_PULSE + 1u) >> 1;
+    if (limit > (pwm->config.period >> 1))
+    {
+        limit = pwm->config.period >> 1;
+    }
+    pwm->config.compare_min = (uint16_t)limit;
+    pwm->config.compare_max = (uint16_t)(pwm->config.period - limit);
+    pwm->config.span_max = (uint16_t)(((uint32_t)(pwm->config.compare_max - pwm->config.compare_min) << 15) / pwm->config.period);
+    pwm->config.span_inv = (pwm->config.span_max > 8192u) ? (uint16_t)((1u << 29) / pwm->config.span_max) : 65535u;
+    pwm->config.dtc_offset = (uint16_t)((pwm->config.deadtime + 1u) >> 1);
+    pwm->config.dtc_slope = ((uint32_t)pwm->config.dtc_offset << 16) / (uint32_t)FOC_FLOAT_TO_Q15(FOC_DTC_CURRENT_BAND);
+    FOC_SVPWM_SetBusVoltage(pwm, 32768u);
+}
+
+const FOC_PWMConfig_t *FOC_SVPWM_GetConfig(const FOC_SVPWM_t *pwm)
+{
+    return &pwm->config;
+}
+
+/********************************************************************************
+ * 矢量作用时间 -> 比较值
+ * t为Q15格式的时间（最大0.5个周期），PWM1模式下CNT < CCR时输出有效，
+ * 占空比 = 1 - 2t，比较值 = ARR - (t * 2ARR >> 15)
+ *********************************************************************************/
+static inline uint16_t SVPWM_ClampCompare(const FOC_SVPWM_t *pwm, int32_t compare)
+{
+    if (compare < (int32_t)pwm->config.compare_min)
+    {
+        compare = pwm->config.compare_min;
+    }
+    else if (compare > (int32_t)pwm->config.compare_max)
+    {
+        compare = pwm->config.compare_max;
+    }
+    return (uint16_t)compare;
+}
+
+static inline uint16_t SVPWM_TimeToCompare(const FOC_SVPWM_t *pwm, uint32_t t)
+{
+    return SVPWM_ClampCompare(pwm, (int32_t)pwm->config.period - (int32_t)((t * pwm->config.period) >> 14));
+}
+
+FOC_RAMFUNC FOC_PWMCounter_t FOC_SVPWM_GetPWMCounter(const FOC_SVPWM_t *pwm, uint8_t sector, const FOC_VectorTime_t *t_VectorTime)
 {
     FOC_PWMCounter_t c_PWMCounter;
+    uint16_t ta, tb, tc;
+
     switch (sector)
     {
     case 1:
-        c_PWMCounter.counter_0 = t_VectorTime->t1;
-        c_PWMCounter.counter_1 = t_VectorTime->t0;
-        c_PWMCounter.counter_2 = t_VectorTime->t2;
+        ta = t_VectorTime->t1;
+        tb = t_VectorTime->t0;
+        tc = t_VectorTime->t2;
         break;
 
     case 2:
-        c_PWMCounter.counter_0 = t_VectorTime->t0;
-        c_PWMCounter.counter_1 = t_VectorTime->t2;
-        c_PWMCounter.counter_2 = t_VectorTime->t1;
+        ta = t_VectorTime->t0;
+        tb = t_VectorTime->t2;
+        tc = t_VectorTime->t1;
         break;
 
     case 3:
-        c_PWMCounter.counter_0 = t_VectorTime->t0;
-        c_PWMCounter.counter_1 = t_VectorTime->t1;
-        c_PWMCounter.counter_2 = t_VectorTime->t2;
+        ta = t_VectorTime->t0;
+        tb = t_VectorTime->t1;
+        tc = t_VectorTime->t2;
         break;
 
     case 4:
-        c_PWMCounter.counter_0 = t_VectorTime->t2;
-        c_PWMCounter.counter_1 = t_VectorTime->t1;
-        c_PWMCounter.counter_2 = t_VectorTime->t0;
+        ta = t_VectorTime->t2;
+        tb = t_VectorTime->t1;
+        tc = t_VectorTime->t0;
         break;
 
     case 5:
-        c_PWMCounter.counter_0 = t_VectorTime->t2;
-        c_PWMCounter.counter_1 = t_VectorTime->t0;
-        c_PWMCounter.counter_2 = t_VectorTime->t1;
+        ta = t_VectorTime->t2;
+        tb = t_VectorTime->t0;
+        tc = t_VectorTime->t1;
         break;
 
     case 6:
-        c_PWMCounter.counter_0 = t_VectorTime->t1;
-        c_PWMCounter.counter_1 = t_VectorTime->t2;
-        c_PWMCounter.counter_2 = t_VectorTime->t0;
+        ta = t_VectorTime->t1;
+        tb = t_VectorTime->t2;
+        tc = t_VectorTime->t0;
+        break;
+
+    default: /* 零矢量 */
+        ta = t_VectorTime->t0;
+        tb = t_VectorTime->t0;
+        tc = t_VectorTime->t0;
         break;
     }
-    c_PWMCounter.counter_0 *= 5000;
-    c_PWMCounter.counter_1 *= 5000;
-    c_PWMCounter.counter_2 *= 5000;
+    c_PWMCounter.counter_0 = SVPWM_TimeToCompare(pwm, ta);
+    c_PWMCounter.counter_1 = SVPWM_TimeToCompare(pwm, tb);
+    c_PWMCounter.counter_2 = SVPWM_TimeToCompare(pwm, tc);
 
     return c_PWMCounter;
 }
-void FOC_SVPWM_Debug(void)
+/********************************************************************************
+ * 最大最小值零序注入SVPWM（无扇区判断）
+ * Clarke逆变换得到三相电压，减去 (max + min) / 2 的零序分量后直接换算为比较值：
+ *   CCR = ARR * (1/2 + (Vx - (Vmax + Vmin) / 2) / Udc)
+ * 与七段式SVPWM的占空比完全等价；Vmax - Vmin超出可用六边形时按比例缩小，
+ * 与SVPWM_VectorTime中 Tx + Ty 超限的处理一致
+ * alpha/beta为Q15（1.0对应实际母线电压），由外层按pwm->bus换算
+ *********************************************************************************/
+static FOC_RAMFUNC FOC_PWMCounter_t SVPWM_MinMax(FOC_SVPWM_t *pwm, int32_t alpha, int32_t beta)
 {
-    uint8_t sector;
-    FOC_VectorTime_t t_VectorTime;
     FOC_PWMCounter_t c_PWMCounter;
-    test_ElectricalAngle += 0.1f;
-    I_dq.id = 0.0;
-    I_dq.iq = 2.5;
-    Limit_Angle(&test_ElectricalAngle);
-    I_AlphaBeta = FOC_Inverse_Park_Transform(&I_dq, test_ElectricalAngle); /* 帕克逆变换 */
-    sector = FOC_SVPWM_GetSector(&I_AlphaBeta);
-    t_VectorTime = FOC_SVPWM_GetVectorTime(sector, &I_AlphaBeta);
-    c_PWMCounter = FOC_SVPWM_GetPWMCounter(sector, &t_VectorTime);
-    __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, c_PWMCounter.counter_0);
-    __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_2, c_PWMCounter.counter_1);
-    __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_3, c_PWMCounter.counter_2);
-    debug("%f,%f,%f,%f,%f,%f,%f,%f\r\n",
-          test_ElectricalAngle,
-            /*
-            t_VectorTime.t0*10, \
-            t_VectorTime.t1*10, \
-            t_VectorTime.t2*10, \
-            */
-          c_PWMCounter.counter_0,
-          c_PWMCounter.counter_1,
-          c_PWMCounter.counter_2,
-          I_AlphaBeta.alpha,
-          I_AlphaBeta.beta,
-          I_dq.id,
-          I_dq.iq);
+    int32_t va, vb, vc, vmax, vmin, offset, span;
+    int32_t period = pwm->config.period;
+
+    va = alpha;
+    vb = (-(alpha << 14) + 28378 * beta) >> 15; /* -1/2 * alpha + √3/2 * beta */
+    vc = -va - vb;
+
+    vmax = (va > vb) ? va : vb;
+    vmax = (vc > vmax) ? vc : vmax;
+    vmin = (va < vb) ? va : vb;
+    vmin = (vc < vmin) ? vc : vmin;
+    offset = (vmax + vmin) >> 1;
+    va -= offset;
+    vb -= offset;
+    vc -= offset;
+
+    /* Vmax - Vmin即七段式SVPWM的 Tx + Ty */
+    span = vmax - vmin;
+    pwm->time_sum = span;
+    if (span > pwm->config.span_max)
+    {
+        va = (int32_t)(((int64_t)va * pwm->config.span_max) / span);
+        vb = (int32_t)(((int64_t)vb * pwm->config.span_max) / span);
+        vc = (int32_t)(((int64_t)vc * pwm->config.span_max) / span);
+    }
+
+    /* 与SVPWM_TimeToCompare相同的取整方式：CCR = ARR - ARR * (1/2 - Vx) */
+    c_PWMCounter.counter_0 = SVPWM_ClampCompare(pwm, period - (((16384 - va) * period) >> 15));
+    c_PWMCounter.counter_1 = SVPWM_ClampCompare(pwm, period - (((16384 - vb) * period) >> 15));
+    c_PWMCounter.counter_2 = SVPWM_ClampCompare(pwm, period - (((16384 - vc) * period) >> 15));
+
+    return c_PWMCounter;
+}
+
+FOC_PWMCounter_t FOC_SVPWM_MinMax(FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_t *I_AlphaBeta)
+{
+    return SVPWM_MinMax(pwm, SVPWM_VoltToQ15(pwm, I_AlphaBeta->alpha), SVPWM_VoltToQ15(pwm, I_AlphaBeta->beta));
+}
+
+/* 超过母线电压的分量远在六边形之外，饱和后方向略有偏差，不影响线性区 */
+FOC_RAMFUNC FOC_PWMCounter_t FOC_SVPWM_MinMax_Q15(FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_Q15_t *I_AlphaBeta)
+{
+    return SVPWM_MinMax(pwm, FOC_Sat_Q15(((int32_t)I_AlphaBeta->alpha * pwm->bus.udc_inv) >> 14),
+                        FOC_Sat_Q15(((int32_t)I_AlphaBeta->beta * pwm->bus.udc_inv) >> 14));
 }
 
-const float sinTable[512 + 1] =
-    {
-    0.00000000f, 0.01227154f, 0.02454123f, 0.03680722f, 0.04906767f, 0.06132074f,
-    0.07356456f, 0.08579731f, 0.09801714f, 0.11022221f, 0.12241068f, 0.13458071f,
-    0.14673047f, 0.15885814f, 0.17096189f, 0.18303989f, 0.19509032f, 0.20711138f,
-    0.21910124f, 0.23105811f, 0.24298018f, 0.25486566f, 0.26671276f, 0.27851969f,
-    0.29028468f, 0.30200595f, 0.31368174f, 0.32531029f, 0.33688985f, 0.34841868f,
-    0.35989504f, 0.37131719f, 0.38268343f, 0.39399204f, 0.40524131f, 0.41642956f,
-    0.42755509f, 0.43861624f, 0.44961133f, 0.46053871f, 0.47139674f, 0.48218377f,
-    0.49289819f, 0.50353838f, 0.51410274f, 0.52458968f, 0.53499762f, 0.54532499f,
-    0.55557023f, 0.56573181f, 0.57580819f, 0.58579786f, 0.59569930f, 0.60551104f,
-    0.61523159f, 0.62485949f, 0.63439328f, 0.64383154f, 0.65317284f, 0.66241578f,
-    0.67155895f, 0.68060100f, 0.68954054f, 0.69837625f, 0.70710678f, 0.71573083f,
-    0.72424708f, 0.73265427f, 0.74095113f, 0.74913639f, 0.75720885f, 0.76516727f,
-    0.77301045f, 0.78073723f, 0.78834643f, 0.79583690f, 0.80320753f, 0.81045720f,
-    0.81758481f, 0.82458930f, 0.83146961f, 0.83822471f, 0.84485357f, 0.85135519f,
-    0.85772861f, 0.86397286f, 0.87008699f, 0.87607009f, 0.88192126f, 0.88763962f,
-    0.89322430f, 0.89867447f, 0.90398929f, 0.90916798f, 0.91420976f, 0.91911385f,
-    0.92387953f, 0.92850608f, 0.93299280f, 0.93733901f, 0.94154407f, 0.94560733f,
-    0.94952818f, 0.95330604f, 0.95694034f, 0.96043052f, 0.96377607f, 0.96697647f,
-    0.97003125f, 0.97293995f, 0.97570213f, 0.97831737f, 0.98078528f, 0.98310549f,
-    0.98527764f, 0.98730142f, 0.98917651f, 0.99090264f, 0.99247953f, 0.99390697f,
-    0.99518473f, 0.99631261f, 0.99729046f, 0.99811811f, 0.99879546f, 0.99932238f,
-    0.99969882f, 0.99992470f, 1.00000000f, 0.99992470f, 0.99969882f, 0.99932238f,
-    0.99879546f, 0.99811811f, 0.99729046f, 0.99631261f, 0.99518473f, 0.99390697f,
-    0.99247953f, 0.99090264f, 0.98917651f, 0.98730142f, 0.98527764f, 0.98310549f,
-    0.98078528f, 0.97831737f, 0.97570213f, 0.97293995f, 0.97003125f, 0.96697647f,
-    0.96377607f, 0.96043052f, 0.95694034f, 0.95330604f, 0.94952818f, 0.94560733f,
-    0.94154407f, 0.93733901f, 0.93299280f, 0.92850608f, 0.92387953f, 0.91911385f,
-    0.91420976f, 0.90916798f, 0.90398929f, 0.89867447f, 0.89322430f, 0.88763962f,
-    0.88192126f, 0.87607009f, 0.87008699f, 0.86397286f, 0.85772861f, 0.85135519f,
-    0.84485357f, 0.83822471f, 0.83146961f, 0.82458930f, 0.81758481f, 0.81045720f,
-    0.80320753f, 0.79583690f, 0.78834643f, 0.78073723f, 0.77301045f, 0.76516727f,
-    0.75720885f, 0.74913639f, 0.74095113f, 0.73265427f, 0.72424708f, 0.71573083f,
-    0.70710678f, 0.69837625f, 0.68954054f, 0.68060100f, 0.67155895f, 0.66241578f,
-    0.65317284f, 0.64383154f, 0.63439328f, 0.62485949f, 0.61523159f, 0.60551104f,
-    0.59569930f, 0.58579786f, 0.57580819f, 0.56573181f, 0.55557023f, 0.54532499f,
-    0.53499762f, 0.52458968f, 0.51410274f, 0.50353838f, 0.49289819f, 0.48218377f,
-    0.47139674f, 0.46053871f, 0.44961133f, 0.43861624f, 0.42755509f, 0.41642956f,
-    0.40524131f, 0.39399204f, 0.38268343f, 0.37131719f, 0.35989504f, 0.34841868f,
-    0.33688985f, 0.32531029f, 0.31368174f, 0.30200595f, 0.29028468f, 0.27851969f,
-    0.26671276f, 0.25486566f, 0.24298018f, 0.23105811f, 0.21910124f, 0.20711138f,
-    0.19509032f, 0.18303989f, 0.17096189f, 0.15885814f, 0.14673047f, 0.13458071f,
-    0.12241068f, 0.11022221f, 0.09801714f, 0.08579731f, 0.07356456f, 0.06132074f,
-    0.04906767f, 0.03680722f, 0.02454123f, 0.01227154f, 0.00000000f, -0.01227154f,
-    -0.02454123f, -0.03680722f, -0.04906767f, -0.06132074f, -0.07356456f,
-    -0.08579731f, -0.09801714f, -0.11022221f, -0.12241068f, -0.13458071f,
-    -0.14673047f, -0.15885814f, -0.17096189f, -0.18303989f, -0.19509032f,
-    -0.20711138f, -0.21910124f, -0.23105811f, -0.24298018f, -0.25486566f,
-    -0.26671276f, -0.27851969f, -0.29028468f, -0.30200595f, -0.31368174f,
-    -0.32531029f, -0.33688985f, -0.34841868f, -0.35989504f, -0.37131719f,
-    -0.38268343f, -0.39399204f, -0.40524131f, -0.41642956f, -0.42755509f,
-    -0.43861624f, -0.44961133f, -0.46053871f, -0.47139674f, -0.48218377f,
-    -0.49289819f, -0.50353838f, -0.51410274f, -0.52458968f, -0.53499762f,
-    -0.54532499f, -0.55557023f, -0.56573181f, -0.57580819f, -0.58579786f,
-    -0.59569930f, -0.60551104f, -0.61523159f, -0.62485949f, -0.63439328f,
-    -0.64383154f, -0.65317284f, -0.66241578f, -0.67155895f, -0.68060100f,
-    -0.68954054f, -0.69837625f, -0.70710678f, -0.71573083f, -0.72424708f,
-    -0.73265427f, -0.74095113f, -0.74913639f, -0.75720885f, -0.76516727f,
-    -0.77301045f, -0.78073723f, -0.78834643f, -0.79583690f, -0.80320753f,
-    -0.81045720f, -0.81758481f, -0.82458930f, -0.83146961f, -0.83822471f,
-    -0.84485357f, -0.85135519f, -0.85772861f, -0.86397286f, -0.87008699f,
-    -0.87607009f, -0.88192126f, -0.88763962f, -0.89322430f, -0.89867447f,
-    -0.90398929f, -0.90916798f, -0.91420976f, -0.91911385f, -0.92387953f,
-    -0.92850608f, -0.93299280f, -0.93733901f, -0.94154407f, -0.94560733f,
-    -0.94952818f, -0.95330604f, -0.95694034f, -0.96043052f, -0.96377607f,
-    -0.96697647f, -0.97003125f, -0.97293995f, -0.97570213f, -0.97831737f,
-    -0.98078528f, -0.98310549f, -0.98527764f, -0.98730142f, -0.98917651f,
-    -0.99090264f, -0.99247953f, -0.99390697f, -0.99518473f, -0.99631261f,
-    -0.99729046f, -0.99811811f, -0.99879546f, -0.99932238f, -0.99969882f,
-    -0.99992470f, -1.00000000f, -0.99992470f, -0.99969882f, -0.99932238f,
-    -0.99879546f, -0.99811811f, -0.99729046f, -0.99631261f, -0.99518473f,
-    -0.99390697f, -0.99247953f, -0.99090264f, -0.98917651f, -0.98730142f,
-    -0.98527764f, -0.98310549f, -0.98078528f, -0.97831737f, -0.97570213f,
-    -0.97293995f, -0.97003125f, -0.96697647f, -0.96377607f, -0.96043052f,
-    -0.95694034f, -0.95330604f, -0.94952818f, -0.94560733f, -0.94154407f,
-    -0.93733901f, -0.93299280f, -0.92850608f, -0.92387953f, -0.91911385f,
-    -0.91420976f, -0.90916798f, -0.90398929f, -0.89867447f, -0.89322430f,
-    -0.88763962f, -0.88192126f, -0.87607009f, -0.87008699f, -0.86397286f,
-    -0.85772861f, -0.85135519f, -0.84485357f, -0.83822471f, -0.83146961f,
-    -0.82458930f, -0.81758481f, -0.81045720f, -0.80320753f, -0.79583690f,
-    -0.78834643f, -0.78073723f, -0.77301045f, -0.76516727f, -0.75720885f,
-    -0.74913639f, -0.74095113f, -0.73265427f, -0.72424708f, -0.71573083f,
-    -0.70710678f, -0.69837625f, -0.68954054f, -0.68060100f, -0.67155895f,
-    -0.66241578f, -0.65317284f, -0.64383154f, -0.63439328f, -0.62485949f,
-    -0.61523159f, -0.60551104f, -0.59569930f, -0.58579786f, -0.57580819f,
-    -0.56573181f, -0.55557023f, -0.54532499f, -0.53499762f, -0.52458968f,
-    -0.51410274f, -0.50353838f, -0.49289819f, -0.48218377f, -0.47139674f,
-    -0.46053871f, -0.44961133f, -0.43861624f, -0.42755509f, -0.41642956f,
-    -0.40524131f, -0.39399204f, -0.38268343f, -0.37131719f, -0.35989504f,
-    -0.34841868f, -0.33688985f, -0.32531029f, -0.31368174f, -0.30200595f,
-    -0.29028468f, -0.27851969f, -0.26671276f, -0.25486566f, -0.24298018f,
-    -0.23105811f, -0.21910124f, -0.20711138f, -0.19509032f, -0.18303989f,
-    -0.17096189f, -0.15885814f, -0.14673047f, -0.13458071f, -0.12241068f,
-    -0.11022221f, -0.09801714f, -0.08579731f, -0.07356456f, -0.06132074f,
-    -0.04906767f, -0.03680722f, -0.02454123f, -0.01227154f, -0.00000000f,
+/********************************************************************************
+ * 过调制（电压幅值m以可用六边形为基值，即 Udc * span_max，Q15；Udc为实际母线电压）
+ *   m <= 1/√3：         线性区，不处理
+ *   1/√3 < m < 0.6057： I区，幅值乘以补偿增益，超出六边形的部分由调制器按比例缩小
+ *                       （最小相位误差），补偿后基波幅值等于给定
+ *   0.6057 <= m < 2/π： II区，电压矢量在每个60°扇区的两端保持在基本矢量上（保持角αh），
+ *                       其余角度沿六边形边线移动，αh = 30°时即六步方波
+ * 补偿增益与保持角随m非线性变化，离线按基波等效数值求解后存表，
+ * 运行时只做线性插值，没有除法与迭代；线性区只多一次平方和比较
+ *********************************************************************************/
+#define OVERMOD_M_LINEAR    18919           /*1/√3，Q15*/
+#define OVERMOD_M_REGION1   19847           /*I区上限 0.60570（轨迹为六边形），Q15*/
+#define OVERMOD_M_SIXSTEP   20861           /*2/π，Q15*/
+#define OVERMOD_K_REGION1   2260            /*FOC_OVERMOD_TABLE_SIZE * 2^16 / (I区宽度)*/
+#define OVERMOD_K_REGION2   2068            /*FOC_OVERMOD_TABLE_SIZE * 2^16 / (II区宽度)*/
+#define OVERMOD_VERTEX      21845           /*基本矢量幅值 2/3，Q15*/
+
+/* I区幅值补偿增益（Q14），m由1/√3等分到0.6057 */
+static const uint16_t Overmod_GainTable[FOC_OVERMOD_TABLE_SIZE + 1] FOC_RAMDATA =
+    {
+    16384, 16386, 16390, 16395, 16402, 16410, 16420, 16430, 16442, 16455, 16470,
+    16486, 16504, 16523, 16544, 16567, 16591, 16618, 16647, 16679, 16713, 16751,
+    16792, 16837, 16888, 16943, 17006, 17078, 17161, 17260, 17384, 17557, 18033,
 };
 
-float arm_cos(float x)
+/* II区保持角αh（65536对应60°），m由0.6057等分到2/π */
+static const uint16_t Overmod_HoldTable[FOC_OVERMOD_TABLE_SIZE + 1] FOC_RAMDATA =
+    {
+    0, 516, 1048, 1588, 2137, 2696, 3265, 3844, 4435, 5038, 5654,
+    6284, 6928, 7588, 8265, 8961, 9677, 10416, 11179, 11969, 12790, 13646,
+    14540, 15480, 16473, 17530, 18665, 19898, 21261, 22808, 24643, 27035, 32768,
+};
+
+/* II区边线段角度缩放 1 / (1 - 2αh/60°)（Q12），与Overmod_HoldTable一一对应 */
+static const uint16_t Overmod_ScaleTable[FOC_OVERMOD_TABLE_SIZE + 1] FOC_RAMDATA =
+    {
+    4096, 4162, 4231, 4305, 4382, 4463, 4549, 4640, 4737, 4840, 4950,
+    5068, 5194, 5330, 5478, 5638, 5813, 6005, 6217, 6453, 6718, 7019,
+    7363, 7764, 8237, 8808, 9517, 10429, 11664, 13476, 16519, 23411, 65535,
+};
+
+/* 六个基本矢量的电角度（16位） */
+static const uint16_t Overmod_VertexAngle[7] FOC_RAMDATA = {0, 10923, 21845, 32768, 43691, 54613, 0};
+
+/* 当前过调制方式与母线电压下有意义的最大电压幅值（Q15，基值FOC_Q15_BASE） */
+static FOC_RAMFUNC FOC_Q15_t SVPWM_VoltageLimit(const FOC_SVPWM_t *pwm)
+{
+    switch (pwm->overmod)
+    {
+    case FOC_OVERMOD_REGION1:
+        return FOC_Sat_Q15((int32_t)((OVERMOD_M_REGION1 * (uint32_t)pwm->bus.span) >> 15));
+
+    case FOC_OVERMOD_SIXSTEP:
+        return FOC_Sat_Q15((int32_t)((OVERMOD_M_SIXSTEP * (uint32_t)pwm->bus.span) >> 15));
+
+    default:
+        return FOC_Sat_Q15((int32_t)(((uint32_t)FOC_FLOAT_TO_Q15(UDC * _1_DIV_SQRT_3) * pwm->bus.udc) >> 15));
+    }
+}
+
+void FOC_SVPWM_SetOvermodulation(FOC_SVPWM_t *pwm, uint8_t mode)
+{
+    pwm->overmod = mode;
+    pwm->bus.v_limit = SVPWM_VoltageLimit(pwm);
+}
+
+uint8_t FOC_SVPWM_GetOvermodulation(const FOC_SVPWM_t *pwm)
+{
+    return pwm->overmod;
+}
+
+/* 电流环PI输出限幅，随过调制方式与母线电压变化 */
+FOC_Q15_t FOC_SVPWM_GetVoltageLimit_Q15(const FOC_SVPWM_t *pwm)
+{
+    return pwm->bus.v_limit;
+}
+
+/* 表插值，pos为Q16格式的表索引 */
+static inline int32_t Overmod_Lookup(const uint16_t *table, uint32_t pos)
+{
+    uint32_t i = pos >> 16;
+    int32_t fract = (int32_t)((pos >> 4) & 0xFFFu);
+
+    if (i >= FOC_OVERMOD_TABLE_SIZE)
+    {
+        return table[FOC_OVERMOD_TABLE_SIZE];
+    }
+    return table[i] + ((((int32_t)table[i + 1] - table[i]) * fract) >> 12);
+}
+
+FOC_RAMFUNC FOC_Alpha_Beta_Q15_t FOC_SVPWM_Overmodulate_Q15(const FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_Q15_t *I_AlphaBeta)
+{
+    FOC_Alpha_Beta_Q15_t v = *I_AlphaBeta;
+    FOC_Angle_t angle;
+    FOC_Q15_t sinTheta, cosTheta;
+    int32_t m, gain, hold, local;
+    uint32_t pos, p, s, out;
+
+    m = (OVERMOD_M_LINEAR * pwm->bus.span) >> 15;
+    /* 两个分量都接近满量程时平方和可达2^31，超出int32，按无符号计算 */
+    if (pwm->overmod == FOC_OVERMOD_NONE ||
+        (uint32_t)((int32_t)v.alpha * v.alpha) + (uint32_t)((int32_t)v.beta * v.beta) <= (uint32_t)(m * m))
+    {
+        return v;
+    }
+    m = (int32_t)(((uint32_t)FOC_Polar_Q15(I_AlphaBeta, &angle) * pwm->bus.span_inv) >> 14);
+
+    if (m < OVERMOD_M_REGION1 || pwm->overmod == FOC_OVERMOD_REGION1)
+    {
+        gain = Overmod_Lookup(Overmod_GainTable, (uint32_t)(m - OVERMOD_M_LINEAR) * OVERMOD_K_REGION1);
+        v.alpha = FOC_Sat_Q15((v.alpha * gain) >> 14);
+        v.beta = FOC_Sat_Q15((v.beta * gain) >> 14);
+        return v;
+    }
+
+    /* 扇区内位置local：65536对应60°，保持区内输出基本矢量，其余按比例映射到整条边线 */
+    pos = (uint32_t)(m - OVERMOD_M_REGION1) * OVERMOD_K_REGION2;
+    hold = Overmod_Lookup(Overmod_HoldTable, pos);
+    p = (uint32_t)FOC_ANGLE_TO_U16(angle) * 6u;
+    s = p >> 16;
+    local = (int32_t)(p & 0xFFFFu);
+    if (local <= hold)
+    {
+        out = 0;
+    }
+    else if (local >= 65536 - hold)
+    {
+        out = 65536;
+    }
+    else
+    {
+        out = (uint32_t)(((local - hold) * Overmod_Lookup(Overmod_ScaleTable, pos)) >> 12);
+        if (out > 65536)
+        {
+            out = 65536;
+        }
+    }
+    /* 幅值取基本矢量长度，调制器按比例缩小后恰好落在六边形上 */
+    FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(Overmod_VertexAngle[s] + ((out * 10923u) >> 16)), &sinTheta, &cosTheta);
+    m = (OVERMOD_VERTEX * pwm->bus.span) >> 15;
+    v.alpha = FOC_Sat_Q15((m * cosTheta) >> 15);
+    v.beta = FOC_Sat_Q15((m * sinTheta) >> 15);
+    return v;
+}
+
+/********************************************************************************
+ * 母线电压前馈
+ * udc为滤波后的母线电压（无符号Q15，32768对应FOC_Q15_BASE），每个控制周期更新一次；
+ * 这里完成唯一的一次除法，矢量作用时间、比较值与过调制只用缓存的倒数做乘法，
+ * 母线电压跌落时输出的相电压幅值保持不变
+ *********************************************************************************/
+FOC_RAMFUNC void FOC_SVPWM_SetBusVoltage(FOC_SVPWM_t *pwm, uint16_t udc)
+{
+    uint32_t span_inv;
+
+    if (udc < FOC_BUS_UDC_MIN)
+    {
+        udc = FOC_BUS_UDC_MIN;
+    }
+    pwm->bus.udc = udc;
+    pwm->bus.udc_inv = (uint16_t)((1u << 29) / udc);
+    pwm->bus.span = (uint16_t)(((uint32_t)pwm->config.span_max * udc) >> 15);
+    span_inv = ((uint32_t)pwm->config.span_inv * pwm->bus.udc_inv) >> 14;
+    pwm->bus.span_inv = (span_inv > 65535u) ? 65535u : (uint16_t)span_inv;
+    pwm->bus.v_limit = SVPWM_VoltageLimit(pwm);
+}
+
+const FOC_BusVoltage_t *FOC_SVPWM_GetBusVoltage(const FOC_SVPWM_t *pwm)
+{
+    return &pwm->bus;
+}
+
+/********************************************************************************
+ * 调制度：最近一次调制的 (Tx + Ty) / 可用六边形（Q15，32768对应六边形边界）
+ * 在限幅前取值，超出六边形（电压饱和）时大于32768，最大65535
+ *********************************************************************************/
+FOC_RAMFUNC uint16_t FOC_SVPWM_GetModulation(const FOC_SVPWM_t *pwm)
+{
+    uint64_t m;
+
+    if (pwm->time_sum <= 0)
+    {
+        return 0;
+    }
+    m = ((uint64_t)pwm->time_sum * pwm->config.span_inv) >> 14;
+    return (m > 65535u) ? 65535u : (uint16_t)m;
+}
+
+/********************************************************************************
+ * 不连续调制（DPWM）
+ * 连续SVPWM的三相比较值加上同一个偏移，线电压不变，钳位相：
+ *   钳位到100%：偏移 = ARR - Cmax，该相CCR = ARR + 1（整个周期有效）
+ *   钳位到0%：  偏移 = -Cmin，     该相CCR = 0（整个周期无效）
+ * 钳位相由比较值大小关系决定（比较值与相电压同序）：
+ *   DPWM1：   Cmax + Cmin >= 2Cmid（电压最高相绝对值最大）时钳位最高相到100%，否则最低相到0%
+ *   DPWM0：   线电压 Vx - Vx+1 绝对值最大（即最高相的下一相是最低相）时钳位最高相到100%，否则最低相到0%
+ *   DPWMMAX： 始终钳位最高相到100%
+ * 偏移后非钳位相若落入比较值限幅之外，同样钳位，避免产生窄脉冲
+ *********************************************************************************/
+void FOC_SVPWM_SetDiscontinuous(FOC_SVPWM_t *pwm, uint8_t mode)
+{
+    pwm->dpwm = mode;
+}
+
+uint8_t FOC_SVPWM_GetDiscontinuous(const FOC_SVPWM_t *pwm)
+{
+    return pwm->dpwm;
+}
+
+FOC_RAMFUNC void FOC_SVPWM_Discontinuous(const FOC_SVPWM_t *pwm, FOC_PWMCounter_t *c_PWMCounter)
+{
+    int32_t c[3], offset;
+    uint32_t imax = 0, imin = 0, imid, i;
+    uint8_t high;
+
+    c[0] = c_PWMCounter->counter_0;
+    c[1] = c_PWMCounter->counter_1;
+    c[2] = c_PWMCounter->counter_2;
+    for (i = 1; i < 3; i++)
+    {
+        if (c[i] > c[imax])
+        {
+            imax = i;
+        }
+        if (c[i] < c[imin])
+        {
+            imin = i;
+        }
+    }
+    if (imax == imin)
+    {
+        imin = (imax + 1u) % 3u;
+    }
+    imid = 3u - imax - imin;
+
+    switch (pwm->dpwm)
+    {
+    case FOC_DPWM_0:
+        high = (imin == (imax + 1u) % 3u);
+        break;
+
+    case FOC_DPWM_1:
+        high = (c[imax] + c[imin] >= 2 * c[imid]);
+        break;
+
+    case FOC_DPWM_MAX:
+        high = 1;
+        break;
+
+    default:
+        return;
+    }
+
+    if (high)
+    {
+        offset = (int32_t)pwm->config.period - c[imax];
+        for (i = 0; i < 3; i++)
+        {
+            c[i] += offset;
+            if (c[i] > (int32_t)pwm->config.compare_max)
+            {
+                c[i] = pwm->config.period + 1;
+            }
+        }
+    }
+    else
+    {
+        offset = c[imin];
+        for (i = 0; i < 3; i++)
+        {
+            c[i] -= offset;
+            if (c[i] < (int32_t)pwm->config.compare_min)
+            {
+                c[i] = 0;
+            }
+        }
+    }
+    c_PWMCounter->counter_0 = (uint16_t)c[0];
+    c_PWMCounter->counter_1 = (uint16_t)c[1];
+    c_PWMCounter->counter_2 = (uint16_t)c[2];
+}
+
+/********************************************************************************
+ * SVPWM调制：alpha/beta电压 -> 三相比较值，实现方式由FOC_SVPWM_MODE选择
+ *********************************************************************************/
+static FOC_RAMFUNC FOC_PWMCounter_t SVPWM_Modulate(FOC_SVPWM_t *pwm, int32_t alpha, int32_t beta)
+{
+    FOC_PWMCounter_t c_PWMCounter;
+#if FOC_SVPWM_MODE == FOC_SVPWM_MODE_MINMAX
+    FOC_PROFILE_START(FOC_PROFILE_MINMAX);
+    c_PWMCounter = SVPWM_MinMax(pwm, alpha, beta);
+    FOC_PROFILE_STOP(FOC_PROFILE_MINMAX);
+#else
+    uint8_t sector;
+    FOC_VectorTime_t t_VectorTime;
+
+    {
+        FOC_PROFILE_START(FOC_PROFILE_SECTOR);
+        sector = SVPWM_Sector(alpha, beta);
+        FOC_PROFILE_STOP(FOC_PROFILE_SECTOR);
+    }
+    {
+        FOC_PROFILE_START(FOC_PROFILE_VECTOR_TIME);
+        t_VectorTime = SVPWM_VectorTime(pwm, sector, alpha, beta);
+        FOC_PROFILE_STOP(FOC_PROFILE_VECTOR_TIME);
+    }
+    {
+        FOC_PROFILE_START(FOC_PROFILE_PWM_COUNTER);
+        c_PWMCounter = FOC_SVPWM_GetPWMCounter(pwm, sector, &t_VectorTime);
+        FOC_PROFILE_STOP(FOC_PROFILE_PWM_COUNTER);
+    }
+#endif
+    if (pwm->dpwm != FOC_DPWM_NONE)
+    {
+        FOC_PROFILE_START(FOC_PROFILE_DPWM);
+        FOC_SVPWM_Discontinuous(pwm, &c_PWMCounter);
+        FOC_PROFILE_STOP(FOC_PROFILE_DPWM);
+    }
+    return c_PWMCounter;
+}
+
+FOC_PWMCounter_t FOC_SVPWM_Modulate(FOC_SVPWM_t *pwm, FOC_Alpha_Beta_t *I_AlphaBeta)
+{
+    if (pwm->overmod != FOC_OVERMOD_NONE)
+    {
+        FOC_Alpha_Beta_Q15_t v_q15 = {FOC_FLOAT_TO_Q15(I_AlphaBeta->alpha), FOC_FLOAT_TO_Q15(I_AlphaBeta->beta)};
+
+        v_q15 = FOC_SVPWM_Overmodulate_Q15(pwm, &v_q15);
+        I_AlphaBeta->alpha = FOC_Q15_TO_FLOAT(v_q15.alpha);
+        I_AlphaBeta->beta = FOC_Q15_TO_FLOAT(v_q15.beta);
+    }
+    return SVPWM_Modulate(pwm, SVPWM_VoltToQ15(pwm, I_AlphaBeta->alpha), SVPWM_VoltToQ15(pwm, I_AlphaBeta->beta));
+}
+
+/* 全程整数运算，扇区法与最大最小值法共用同一次母线电压换算，不再转回浮点 */
+FOC_RAMFUNC FOC_PWMCounter_t FOC_SVPWM_Modulate_Q15(FOC_SVPWM_t *pwm, const FOC_Alpha_Beta_Q15_t *I_AlphaBeta)
+{
+    FOC_Alpha_Beta_Q15_t v_q15;
+    {
+        FOC_PROFILE_START(FOC_PROFILE_OVERMOD);
+        v_q15 = FOC_SVPWM_Overmodulate_Q15(pwm, I_AlphaBeta);
+        FOC_PROFILE_STOP(FOC_PROFILE_OVERMOD);
+    }
+    return SVPWM_Modulate(pwm, FOC_Sat_Q15(((int32_t)v_q15.alpha * pwm->bus.udc_inv) >> 14),
+                          FOC_Sat_Q15(((int32_t)v_q15.beta * pwm->bus.udc_inv) >> 14));
+}
+
+/********************************************************************************
+ * 死区补偿
+ * 中心对齐PWM1模式下上管理想导通 2*CCR 个计数，死区期间桥臂电压由续流二极管决定：
+ *   i > 0（流出桥臂）：上管少导通一个死区，CCR + 死区/2
+ *   i < 0（流入桥臂）：上管多导通一个死区，CCR - 死区/2
+ * 偏移量由BDTR中的死区配置在FOC_SVPWM_Init时算出，电流过零附近
+ * （|i| < FOC_DTC_CURRENT_BAND）按电流线性过渡，避免符号抖动引起的电压跳变；
+ * DPWM钳位相整个周期不开关，没有死区，不补偿
+ *********************************************************************************/
+static inline uint16_t SVPWM_DeadTimeOffset(const FOC_SVPWM_t *pwm, uint16_t compare, FOC_Q15_t current)
+{
+    int32_t offset;
+
+    if (compare == 0 || compare > pwm->config.period)
+    {
+        return compare;
+    }
+    offset = (int32_t)(((int64_t)current * pwm->config.dtc_slope) >> 16);
+
+    if (offset > (int32_t)pwm->config.dtc_offset)
+    {
+        offset = pwm->config.dtc_offset;
+    }
+    else if (offset < -(int32_t)pwm->config.dtc_offset)
+    {
+        offset = -(int32_t)pwm->config.dtc_offset;
+    }
+    return SVPWM_ClampCompare(pwm, (int32_t)compare + offset);
+}
+
+FOC_RAMFUNC void FOC_SVPWM_DeadTimeCompensate(const FOC_SVPWM_t *pwm, FOC_PWMCounter_t *c_PWMCounter, const FOC_U_V_W_Q15_t *i_uvw)
 {
-    float cosVal, fract, in; /* Temporary input, output variables */
-    uint16_t index;          /* Index variable */
-    float a, b;              /* Two nearest output values */
-    int32_t n;
-    float findex;
+    c_PWMCounter->counter_0 = SVPWM_DeadTimeOffset(pwm, c_PWMCounter->counter_0, i_uvw->iu);
+    c_PWMCounter->counter_1 = SVPWM_DeadTimeOffset(pwm, c_PWMCounter->counter_1, i_uvw->iv);
+    c_PWMCounter->counter_2 = SVPWM_DeadTimeOffset(pwm, c_PWMCounter->counter_2, i_uvw->iw);
+}
+
+/********************************************************************************
+ * PI控制器（Q15定点）
+ * kp、ki为实际增益，ki已乘以控制周期（离散积分增益）
+ *********************************************************************************/
+void FOC_PI_Init(FOC_PI_Q15_t *pi, float kp, float ki, FOC_Q15_t out_max)
+{
+    pi->kp = (int32_t)(kp * (float)(1 << FOC_PI_SHIFT));
+    pi->ki = (int32_t)(ki * (float)(1 << FOC_PI_SHIFT));
+    /* kp * error、积分累加不能超出int32 */
+    if (pi->kp > 65535)
+    {
+        pi->kp = 65535;
+    }
+    if (pi->ki > 32767)
+    {
+        pi->ki = 32767;
+    }
+    pi->out_max = out_max;
+    pi->integral = 0;
+}
+
+void FOC_PI_Reset(FOC_PI_Q15_t *pi)
+{
+    pi->integral = 0;
+}
+
+/* 积分预置为给定输出（限幅内），控制器从该输出开始接管，没有阶跃 */
+void FOC_PI_Preset(FOC_PI_Q15_t *pi, FOC_Q15_t out)
+{
+    if (out > pi->out_max)
+    {
+        out = pi->out_max;
+    }
+    else if (out < -pi->out_max)
+    {
+        out = (FOC_Q15_t)-pi->out_max;
+    }
+    pi->integral = (int32_t)out << FOC_PI_SHIFT;
+}
 
-    /* input x is in radians */
-    /* Scale input to [0 1] range from [0 2*PI] , divide input by 2*pi, add 0.25 (pi/2) to read sine table */
-    in = x * 0.159154943092f + 0.25f;
+FOC_RAMFUNC FOC_Q15_t FOC_PI_Update_Q15(FOC_PI_Q15_t *pi, FOC_Q15_t error)
+{
+    int32_t limit = (int32_t)pi->out_max << FOC_PI_SHIFT;
+    int32_t out;
 
-    /* Calculation of floor value of input */
-    n = (int32_t)in;
+    /* 积分限幅（抗积分饱和） */
+    pi->integral += pi->ki * error;
+    if (pi->integral > limit)
+    {
+        pi->integral = limit;
+    }
+    else if (pi->integral < -limit)
+    {
+        pi->integral = -limit;
+    }
 
-    /* Make negative values towards -infinity */
-    if (in < 0.0f)
+    out = ((pi->kp * error) >> FOC_PI_SHIFT) + (pi->integral >> FOC_PI_SHIFT);
+    if (out > pi->out_max)
+    {
+        out = pi->out_max;
+    }
+    else if (out < -pi->out_max)
     {
-        n--;
+        out = -pi->out_max;
     }
+    return (FOC_Q15_t)out;
+}
 
-    /* Map input value to [0 1] */
-    in = in - (float)n;
+/********************************************************************************
+ * 电流环
+ * d、q轴PI输出限幅为当前过调制方式下的最大电压（线性区为 Udc/√3），
+ * 每次更新时按FOC_SVPWM_GetVoltageLimit_Q15刷新，跟随母线电压与过调制方式；
+ * pwm为该电机逆变器的调制器，多个电机各自一个电流环与调制器，互不共享状态
+ *********************************************************************************/
+void FOC_CurrentLoop_Init(FOC_CurrentLoop_t *loop, FOC_SVPWM_t *pwm, float kp, float ki)
+{
+    loop->pwm = pwm;
+    FOC_PI_Init(&loop->pi_d, kp, ki, FOC_SVPWM_GetVoltageLimit_Q15(pwm));
+    FOC_PI_Init(&loop->pi_q, kp, ki, FOC_SVPWM_GetVoltageLimit_Q15(pwm));
+    loop->i_ref.id = 0;
+    loop->i_ref.iq = 0;
+    loop->v_dq.id = 0;
+    loop->v_dq.iq = 0;
+    loop->v_AlphaBeta.alpha = 0;
+    loop->v_AlphaBeta.beta = 0;
+}
 
-    /* Calculation of index of the table */
-    findex = (float)512 * in;
-    index = (uint16_t)findex;
+/* 电流反馈：Clarke -> Park */
+static FOC_RAMFUNC void CurrentLoop_Feedback(FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw, FOC_Angle_t ElectricalAngle)
+{
+    FOC_PROFILE_START(FOC_PROFILE_CLARKE_PARK);
+    loop->i_AlphaBeta = FOC_Clarke_Transform_Q15(i_uvw);
+    loop->i_dq = FOC_Park_Transform_Q15(&loop->i_AlphaBeta, ElectricalAngle);
+    FOC_PROFILE_STOP(FOC_PROFILE_CLARKE_PARK);
+}
 
-    /* when "in" is exactly 1, we need to rotate the index down to 0 */
-    if (index >= 512)
+/* 电压输出：loop->v_dq -> Park逆变换 -> SVPWM -> 死区补偿 */
+static FOC_RAMFUNC const FOC_PWMCounter_t *CurrentLoop_Output(FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw, FOC_Angle_t ElectricalAngle)
+{
+    {
+        FOC_PROFILE_START(FOC_PROFILE_INV_PARK);
+        loop->v_AlphaBeta = FOC_Inverse_Park_Transform_Q15(&loop->v_dq, ElectricalAngle);
+        FOC_PROFILE_STOP(FOC_PROFILE_INV_PARK);
+    }
+    loop->counter = FOC_SVPWM_Modulate_Q15(loop->pwm, &loop->v_AlphaBeta);
+#if FOC_DTC_ENABLE
     {
-        index = 0;
-        findex -= (float)512;
+        FOC_PROFILE_START(FOC_PROFILE_DTC);
+        FOC_SVPWM_DeadTimeCompensate(loop->pwm, &loop->counter, i_uvw);
+        FOC_PROFILE_STOP(FOC_PROFILE_DTC);
     }
+#endif
 
-    /* fractional value calculation */
-    fract = findex - (float)index;
+    return &loop->counter;
+}
 
-    /* Read two nearest values of input value from the cos table */
-    a = sinTable[index];
-    b = sinTable[index + 1];
+/********************************************************************************
+ * 电流环单次更新：三相电流 -> 三相比较值（含死区补偿）
+ * 每个PWM周期在电流采样完成后调用一次，返回值指向loop->counter
+ *********************************************************************************/
+FOC_RAMFUNC const FOC_PWMCounter_t *FOC_CurrentLoop_Update(FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw, FOC_Angle_t ElectricalAngle)
+{
+    CurrentLoop_Feedback(loop, i_uvw, ElectricalAngle);
+    {
+        FOC_PROFILE_START(FOC_PROFILE_PI);
+        loop->pi_d.out_max = loop->pwm->bus.v_limit;
+        loop->pi_q.out_max = loop->pwm->bus.v_limit;
+        loop->v_dq.id = FOC_PI_Update_Q15(&loop->pi_d, FOC_Sat_Q15((FOC_Q31_t)loop->i_ref.id - loop->i_dq.id));
+        loop->v_dq.iq = FOC_PI_Update_Q15(&loop->pi_q, FOC_Sat_Q15((FOC_Q31_t)loop->i_ref.iq - loop->i_dq.iq));
+        FOC_PROFILE_STOP(FOC_PROFILE_PI);
+    }
+    return CurrentLoop_Output(loop, i_uvw, ElectricalAngle);
+}
+
+/********************************************************************************
+ * 电压方式单次更新：不经过PI，直接输出loop->v_dq，同时更新电流反馈loop->i_dq
+ * 用于参数辨识的高频注入等需要指定电压的场合，PI积分保持不变
+ *********************************************************************************/
+FOC_RAMFUNC const FOC_PWMCounter_t *FOC_CurrentLoop_VoltageUpdate(FOC_CurrentLoop_t *loop, const FOC_U_V_W_Q15_t *i_uvw, FOC_Angle_t ElectricalAngle)
+{
+    CurrentLoop_Feedback(loop, i_uvw, ElectricalAngle);
+    return CurrentLoop_Output(loop, i_uvw, ElectricalAngle);
+}
 
-    /* Linear interpolation process */
-    cosVal = (1.0f - fract) * a + fract * b;
+void FOC_SVPWM_Debug(FOC_SVPWM_t *pwm)
+{
+    FOC_PWMCounter_t c_PWMCounter;
+    test_ElectricalAngle += FOC_Angle_FromRad(test_AngleStep);
+    I_dq.id = 0.0;
+    I_dq.iq = 2.5;
+    {
+        FOC_PROFILE_START(FOC_PROFILE_INV_PARK);
+#if FOC_USE_Q15
+        FOC_D_Q_Q15_t dq_q15 = {FOC_FLOAT_TO_Q15(I_dq.id), FOC_FLOAT_TO_Q15(I_dq.iq)};
+        FOC_Alpha_Beta_Q15_t alphabeta_q15 = FOC_Inverse_Park_Transform_Q15(&dq_q15, test_ElectricalAngle);
 
-    /* Return output value */
-    return (cosVal);
+        I_AlphaBeta.alpha = FOC_Q15_TO_FLOAT(alphabeta_q15.alpha);
+        I_AlphaBeta.beta = FOC_Q15_TO_FLOAT(alphabeta_q15.beta);
+#else
+        I_AlphaBeta = FOC_Inverse_Park_Transform(&I_dq, test_ElectricalAngle); /* 帕克逆变换 */
+#endif
+        FOC_PROFILE_STOP(FOC_PROFILE_INV_PARK);
+    }
+    c_PWMCounter = FOC_SVPWM_Modulate(pwm, &I_AlphaBeta);
+    {
+        FOC_PROFILE_START(FOC_PROFILE_COMPARE_WRITE);
+        __HAL_TIM_SET_COMPARE(pwm->htim, TIM_CHANNEL_1, c_PWMCounter.counter_0);
+        __HAL_TIM_SET_COMPARE(pwm->htim, TIM_CHANNEL_2, c_PWMCounter.counter_1);
+        __HAL_TIM_SET_COMPARE(pwm->htim, TIM_CHANNEL_3, c_PWMCounter.counter_2);
+        FOC_PROFILE_STOP(FOC_PROFILE_COMPARE_WRITE);
+    }
+    {
+        FOC_PROFILE_START(FOC_PROFILE_DEBUG);
+        debug("%f,%u,%u,%u,%f,%f,%f,%f\r\n",
+              FOC_Angle_ToRad(test_ElectricalAngle),
+              c_PWMCounter.counter_0,
+              c_PWMCounter.counter_1,
+              c_PWMCounter.counter_2,
+              I_AlphaBeta.alpha,
+              I_AlphaBeta.beta,
+              I_dq.id,
+              I_dq.iq);
+        FOC_PROFILE_STOP(FOC_PROFILE_DEBUG);
+    }
 }
 
-float arm_sin(float x)
+/********************************************************************************
+ * 正弦表由Tools/foc_sin_gen.c按foc_sin_config.h生成（foc_sin_table.c），点数、格式与对称性可配置，
+ * 浮点与定点查表共用同一张表：
+ *   SIN_ENTRY_FLOAT：表项 -> 浮点
+ *   SIN_ENTRY_FIXED：表项 -> Q(15 + SIN_FIXED_FRAC)定点，Q31与浮点表在Q23下插值，最后舍入到Q15
+ *********************************************************************************/
+#if FOC_SIN_FORMAT == FOC_SIN_FORMAT_Q15
+#define SIN_ENTRY_FLOAT(i)      ((float)FOC_SinTable[i] * (1.0f / 32768.0f))
+#define SIN_ENTRY_FIXED(i)      ((FOC_Q31_t)FOC_SinTable[i])
+#define SIN_FIXED_FRAC          0
+#define SIN_FIXED_TO_Q15(x)     ((FOC_Q15_t)(x))
+#else
+#if FOC_SIN_FORMAT == FOC_SIN_FORMAT_Q31
+#define SIN_ENTRY_FLOAT(i)      ((float)FOC_SinTable[i] * (1.0f / 2147483648.0f))
+#define SIN_ENTRY_FIXED(i)      (FOC_SinTable[i] >> 8)
+#else
+#define SIN_ENTRY_FLOAT(i)      (FOC_SinTable[i])
+#define SIN_ENTRY_FIXED(i)      ((FOC_Q31_t)(FOC_SinTable[i] * 8388608.0f))
+#endif
+#define SIN_FIXED_FRAC          8
+#define SIN_FIXED_TO_Q15(x)     FOC_Sat_Q15(((x) + (1 << (SIN_FIXED_FRAC - 1))) >> SIN_FIXED_FRAC)
+#endif
+
+#define SIN_N                   FOC_SIN_TABLE_SIZE
+#define SIN_FRACT_BITS          (FOC_ANGLE_BITS - FOC_SIN_TABLE_ANGLE_BITS)     /*浮点查表的插值系数位数*/
+#define SIN_FRACT_BITS_Q15      (16 - FOC_SIN_TABLE_ANGLE_BITS)                 /*定点查表（16位电角度）的插值系数位数*/
+
+/* 表[i]与表[i + 1]之间线性插值 */
+#define SIN_INTERP_FLOAT(i, fract) \
+    (SIN_ENTRY_FLOAT(i) + (fract) * (SIN_ENTRY_FLOAT((i) + 1u) - SIN_ENTRY_FLOAT(i)))
+#define SIN_INTERP_FIXED(i, fract) \
+    (SIN_ENTRY_FIXED(i) + (((SIN_ENTRY_FIXED((i) + 1u) - SIN_ENTRY_FIXED(i)) * (fract)) >> SIN_FRACT_BITS_Q15))
+
+/********************************************************************************
+ * 同时计算正弦与余弦（浮点）
+ * 电角度高位为表索引，其余低位为线性插值系数，只做一次索引计算：
+ * 1/4周期表：索引最高2位为象限，sin与cos取自表的对称位置
+ *   象限0: sin =  A  cos =  B
+ *   象限1: sin =  B  cos = -A
+ *   象限2: sin = -A  cos = -B
+ *   象限3: sin = -B  cos =  A
+ *   其中 A = 表[i]插值，B = 表[N - i]向表[N - i - 1]插值
+ * 整周期表：sin = 表[i]插值，cos = 表[(i + N/4) mod N]插值
+ *********************************************************************************/
+void FOC_SinCos(FOC_Angle_t ElectricalAngle, float *sinVal, float *cosVal)
 {
-    float sinVal, fract, in; /* Temporary input, output variables */
-    uint16_t index;          /* Index variable */
-    float a, b;              /* Two nearest output values */
-    int32_t n;
-    float findex;
+    uint32_t index = (uint32_t)ElectricalAngle >> SIN_FRACT_BITS;
+    float fract = (float)((uint32_t)ElectricalAngle & ((1u << SIN_FRACT_BITS) - 1u)) *
+                  (1.0f / (float)(1u << SIN_FRACT_BITS));
+#if FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER
+    uint32_t quadrant = index >> FOC_SIN_TABLE_BITS;
+    uint32_t i = index & (SIN_N - 1u);
+    float a, b;
+
+    a = SIN_INTERP_FLOAT(i, fract);
+    b = SIN_ENTRY_FLOAT(SIN_N - i) + fract * (SIN_ENTRY_FLOAT(SIN_N - i - 1u) - SIN_ENTRY_FLOAT(SIN_N - i));
 
-    /* input x is in radians */
-    /* Scale input to [0 1] range from [0 2*PI] , divide input by 2*pi */
-    in = x * 0.159154943092f;
+    switch (quadrant)
+    {
+    case 0:
+        *sinVal = a;
+        *cosVal = b;
+        break;
+
+    case 1:
+        *sinVal = b;
+        *cosVal = -a;
+        break;
+
+    case 2:
+        *sinVal = -a;
+        *cosVal = -b;
+        break;
 
-    /* Calculation of floor value of input */
-    n = (int32_t)in;
+    default:
+        *sinVal = -b;
+        *cosVal = a;
+        break;
+    }
+#else
+    uint32_t j = (index + (SIN_N >> 2)) & (SIN_N - 1u);
 
-    /* Make negative values towards -infinity */
-    if (in < 0.0f)
+    *sinVal = SIN_INTERP_FLOAT(index, fract);
+    *cosVal = SIN_INTERP_FLOAT(j, fract);
+#endif
+}
+
+/********************************************************************************
+ * 同时计算正弦与余弦（Q15定点）
+ * 取电角度高16位，高FOC_SIN_TABLE_ANGLE_BITS位为表索引（1/4周期表含象限），其余为线性插值系数，
+ * 索引与象限折叠同FOC_SinCos
+ *********************************************************************************/
+FOC_RAMFUNC void FOC_SinCos_Q15(FOC_Angle_t ElectricalAngle, FOC_Q15_t *sinVal, FOC_Q15_t *cosVal)
+{
+    uint16_t angle16 = FOC_ANGLE_TO_U16(ElectricalAngle);
+    uint32_t index = (uint32_t)angle16 >> SIN_FRACT_BITS_Q15;
+    FOC_Q31_t fract = angle16 & ((1 << SIN_FRACT_BITS_Q15) - 1);
+#if FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER
+    uint32_t quadrant = index >> FOC_SIN_TABLE_BITS;
+    uint32_t i = index & (SIN_N - 1u);
+    FOC_Q31_t b0 = SIN_ENTRY_FIXED(SIN_N - i);
+    FOC_Q15_t a = SIN_FIXED_TO_Q15(SIN_INTERP_FIXED(i, fract));
+    FOC_Q15_t b = SIN_FIXED_TO_Q15(b0 + (((SIN_ENTRY_FIXED(SIN_N - i - 1u) - b0) * fract) >> SIN_FRACT_BITS_Q15));
+
+    switch (quadrant)
     {
-        n--;
+    case 0:
+        *sinVal = a;
+        *cosVal = b;
+        break;
+
+    case 1:
+        *sinVal = b;
+        *cosVal = (FOC_Q15_t)-a;
+        break;
+
+    case 2:
+        *sinVal = (FOC_Q15_t)-a;
+        *cosVal = (FOC_Q15_t)-b;
+        break;
+
+    default:
+        *sinVal = (FOC_Q15_t)-b;
+        *cosVal = a;
+        break;
     }
+#else
+    uint32_t j = (index + (SIN_N >> 2)) & (SIN_N - 1u);
+
+    *sinVal = SIN_FIXED_TO_Q15(SIN_INTERP_FIXED(index, fract));
+    *cosVal = SIN_FIXED_TO_Q15(SIN_INTERP_FIXED(j, fract));
+#endif
+}
+
+/* CORDIC旋转角 atan(2^-i)，2^32对应2π */
+static const uint32_t Cordic_AtanTable[16] FOC_RAMDATA =
+    {
+    0x20000000, 0x12E4051E, 0x09FB385B, 0x051111D4, 0x028B0D43, 0x0145D7E1, 0x00A2F61E, 0x00517C55,
+    0x0028BE53, 0x00145F2F, 0x000A2F98, 0x000517CC, 0x00028BE6, 0x000145F3, 0x0000A2FA, 0x0000517D,
+};
 
-    /* Map input value to [0 1] */
-    in = in - (float)n;
+#define CORDIC_PRESHIFT     14          /*输入Q15左移14位，迭代增益1.647下最大值仍小于2^31*/
+#define CORDIC_GAIN_INV     39797u      /*CORDIC增益倒数 0.607253，Q16*/
 
-    /* Calculation of index of the table */
-    findex = (float)512 * in;
-    index = (uint16_t)findex;
+/********************************************************************************
+ * 直角坐标 -> 极坐标（CORDIC向量模式，纯整数运算）
+ * 先按x符号旋转0或π使向量落在右半平面，再迭代把y旋转到0：
+ *   y > 0: x += y>>i, y -= x>>i, θ += atan(2^-i)
+ *   y < 0: x -= y>>i, y += x>>i, θ -= atan(2^-i)
+ * 迭代次数固定为FOC_CORDIC_ITERATIONS，无除法、无查表插值，耗时与输入无关
+ * 返回幅值（Q15，未饱和，最大为√2 * 32768），电角度写入ElectricalAngle（可为NULL）
+ * 误差（相对整数输入的精确值，与幅值无关）：
+ *   FOC_CORDIC_ITERATIONS = 16：角度 < 0.82 LSB（16位电角度，0.0045°）
+ *   FOC_CORDIC_ITERATIONS = 12：角度 < 5.5 LSB（0.03°）
+ *   FOC_CORDIC_ITERATIONS = 8： 角度 < 82 LSB（0.45°）
+ *   幅值误差 < 0.6 LSB（Q15），主要来自输出取整
+ * 零向量的角度无意义
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Q31_t FOC_Polar_Q15(const FOC_Alpha_Beta_Q15_t *i_AlphaBeta, FOC_Angle_t *ElectricalAngle)
+{
+    int32_t x = (int32_t)i_AlphaBeta->alpha << CORDIC_PRESHIFT;
+    int32_t y = (int32_t)i_AlphaBeta->beta << CORDIC_PRESHIFT;
+    int32_t dx;
+    uint32_t theta = 0;
+    uint32_t i;
 
-    /* when "in" is exactly 1, we need to rotate the index down to 0 */
-    if (index >= 512)
+    if (x < 0)
     {
-        index = 0;
-        findex -= (float)512;
+        x = -x;
+        y = -y;
+        theta = 0x80000000u;
     }
+    for (i = 0; i < FOC_CORDIC_ITERATIONS; i++)
+    {
+        dx = x >> i;
+        if (y > 0)
+        {
+            x += y >> i;
+            y -= dx;
+            theta += Cordic_AtanTable[i];
+        }
+        else
+        {
+            x -= y >> i;
+            y += dx;
+            theta -= Cordic_AtanTable[i];
+        }
+    }
+    if (ElectricalAngle != NULL)
+    {
+        /* 四舍五入到FOC_ANGLE_BITS位 */
+#if FOC_ANGLE_BITS == 32
+        *ElectricalAngle = (FOC_Angle_t)theta;
+#else
+        *ElectricalAngle = (FOC_Angle_t)((theta + (1u << (31 - FOC_ANGLE_BITS))) >> (32 - FOC_ANGLE_BITS));
+#endif
+    }
+    /* M3上64位乘法为一条UMULL指令 */
+    return (FOC_Q31_t)(((uint64_t)(uint32_t)x * CORDIC_GAIN_INV + (1u << (CORDIC_PRESHIFT + 15))) >> (CORDIC_PRESHIFT + 16));
+}
 
-    /* fractional value calculation */
-    fract = findex - (float)index;
+/* atan2(y, x)，结果为整数电角度（0~2π） */
+FOC_Angle_t FOC_Atan2_Q15(FOC_Q15_t y, FOC_Q15_t x)
+{
+    FOC_Alpha_Beta_Q15_t v = {x, y};
+    FOC_Angle_t angle;
 
-    /* Read two nearest values of input value from the sin table */
-    a = sinTable[index];
-    b = sinTable[index + 1];
+    FOC_Polar_Q15(&v, &angle);
+    return angle;
+}
 
-    /* Linear interpolation process */
-    sinVal = (1.0f - fract) * a + fract * b;
+/* √(x² + y²)，Q15，未饱和 */
+FOC_Q31_t FOC_Magnitude_Q15(FOC_Q15_t x, FOC_Q15_t y)
+{
+    FOC_Alpha_Beta_Q15_t v = {x, y};
 
-    /* Return output value */
-    return (sinVal);
+    return FOC_Polar_Q15(&v, NULL);
 }
@@ -0,0 +1,70 @@
+#include "foc_mtpa.h"
+
+/*查表换算系数，FOC_MTPA_Init中由生成的表范围计算*/
+static struct
+{
+    int32_t i_max;          /*电流圆半径（Q15）*/
+    int32_t torque_max;     /*电流圆上MTPA点的转矩（Q15）*/
+    uint32_t torque_k;      /*转矩（Q15） -> 表索引（Q16），左移8位*/
+    uint32_t id_k;          /*id + Imax（Q15） -> 表索引（Q16），左移8位*/
+} MTPA_Scale;
+
+void FOC_MTPA_Init(void)
+{
+    MTPA_Scale.i_max = FOC_FLOAT_TO_Q15((float)FOC_MTPA_I_MAX_MA * 0.001f);
+    MTPA_Scale.torque_max = FOC_FLOAT_TO_Q15(FOC_MTPA_TorqueMax);
+    MTPA_Scale.torque_k = (uint32_t)((float)FOC_MTPA_TABLE_SIZE * 16777216.0f / (float)MTPA_Scale.torque_max);
+    MTPA_Scale.id_k = (uint32_t)((float)FOC_MTPA_TABLE_SIZE * 16777216.0f / (float)MTPA_Scale.i_max);
+}
+
+/* 线性插值，index为Q16表索引，超出表尾时取最后一项 */
+static FOC_RAMFUNC int32_t MTPA_Interp(const FOC_MTPA_Entry_t *table, uint32_t index)
+{
+    uint32_t i = index >> 16;
+    int32_t a, b;
+
+    if (i >= FOC_MTPA_TABLE_SIZE)
+    {
+        return table[FOC_MTPA_TABLE_SIZE];
+    }
+    a = table[i];
+    b = table[i + 1u];
+    return a + (int32_t)(((int64_t)(b - a) * (int32_t)(index & 0xFFFFu)) >> 16);
+}
+
+/********************************************************************************
+ * 给定转矩与d轴电流下的q轴电流：iq = i_t * ψ / (ψ + (Ld - Lq) * id)
+ * id超出[-Imax, 0]时按端点取值；弱磁改变id后用它保持同一转矩
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Q15_t FOC_MTPA_Iq(FOC_Q15_t torque, FOC_Q15_t id)
+{
+    int32_t x = (int32_t)id + MTPA_Scale.i_max;
+    int32_t ratio;
+
+    if (x < 0)
+    {
+        x = 0;
+    }
+    ratio = MTPA_Interp(FOC_MTPA_FluxTable, (uint32_t)(((uint64_t)(uint32_t)x * MTPA_Scale.id_k) >> 8));
+    return FOC_Sat_Q15((FOC_Q31_t)(((int64_t)torque * ratio) >> (14 + FOC_MTPA_FRAC_BITS)));
+}
+
+/********************************************************************************
+ * 转矩给定 -> MTPA dq电流给定，在速度环输出之后调用
+ * |torque|超过电流圆上的MTPA点时限幅，负转矩id相同、iq取反
+ *********************************************************************************/
+FOC_RAMFUNC void FOC_MTPA_Reference(FOC_Q15_t torque, FOC_D_Q_Q15_t *i_ref)
+{
+    int32_t t = (torque < 0) ? -(int32_t)torque : torque;
+    int32_t id;
+    FOC_PROFILE_START(FOC_PROFILE_MTPA);
+
+    if (t > MTPA_Scale.torque_max)
+    {
+        t = MTPA_Scale.torque_max;
+    }
+    id = MTPA_Interp(FOC_MTPA_IdTable, (uint32_t)(((uint64_t)(uint32_t)t * MTPA_Scale.torque_k) >> 8));
+    i_ref->id = (FOC_Q15_t)(((int64_t)id * MTPA_Scale.i_max) >> (15 + FOC_MTPA_FRAC_BITS));
+    i_ref->iq = FOC_MTPA_Iq((FOC_Q15_t)((torque < 0) ? -t : t), i_ref->id);
+    FOC_PROFILE_STOP(FOC_PROFILE_MTPA);
+}
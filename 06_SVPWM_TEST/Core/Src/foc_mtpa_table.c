@@ -0,0 +1,31 @@
+/* 由Tools/foc_mtpa_gen.c生成，不要手工修改 */
+#include "foc_mtpa_config.h"
+
+#if FOC_MTPA_LD_UH != 800 || FOC_MTPA_LQ_UH != 1000 || FOC_MTPA_FLUX_UWB != 10000 || FOC_MTPA_I_MAX_MA != 3000 || \
+    FOC_MTPA_TABLE_BITS != 5 || FOC_MTPA_FRAC_BITS != 0
+#error "foc_mtpa_table.c does not match foc_mtpa_config.h, rerun Tools/foc_mtpa_gen"
+#endif
+
+/* 电流圆上的MTPA点：id -0.1787 A，折算q轴电流 3.0054 A */
+const float FOC_MTPA_TorqueMax = 3.005376f;
+
+/* MTPA id / Imax，Q(15 + FOC_MTPA_FRAC_BITS)，i_t从0到FOC_MTPA_TorqueMax等分 */
+const FOC_MTPA_Entry_t FOC_MTPA_IdTable[FOC_MTPA_TABLE_SIZE + 1] FOC_RAMDATA =
+    {
+    0, -2, -8, -17, -31, -48, -69, -94,
+    -123, -156, -192, -233, -277, -325, -377, -433,
+    -492, -555, -622, -693, -768, -846, -928, -1014,
+    -1103, -1196, -1293, -1394, -1498, -1606, -1718, -1833,
+    -1952,
+};
+
+/* ψ / (ψ + (Ld - Lq) * id)，Q(14 + FOC_MTPA_FRAC_BITS)，id从-Imax到0等分 */
+const FOC_MTPA_Entry_t FOC_MTPA_FluxTable[FOC_MTPA_TABLE_SIZE + 1] FOC_RAMDATA =
+    {
+    15457, 15484, 15511, 15539, 15567, 15595, 15622, 15650,
+    15678, 15707, 15735, 15763, 15792, 15820, 15849, 15878,
+    15907, 15936, 15965, 15994, 16023, 16053, 16082, 16112,
+    16142, 16172, 16202, 16232, 16262, 16292, 16323, 16353,
+    16384,
+};
+
@@ -0,0 +1,131 @@
+#include "foc_observer.h"
+
+#define OBSERVER_ACC_PER_RAD    683565275.5764316f  /*角度累加器：2^32 / 2π*/
+
+/********************************************************************************
+ * 观测器初始化
+ * 电流、电压均为Q15标幺值（同一基值），因此电阻、电感按基值1Ω折算
+ *********************************************************************************/
+void FOC_Observer_Init(FOC_Observer_t *obs, float rs, float ls, float ts)
+{
+    float lpf = FOC_OBSERVER_LPF_CUTOFF * ts;
+    float wn_ts = FOC_OBSERVER_PLL_BW * ts;
+
+    obs->f = (int32_t)((1.0f - rs * ts / ls) * 32768.0f);
+    obs->g = (int32_t)(ts / ls * 32768.0f);
+    obs->k_slide = FOC_FLOAT_TO_Q15(FOC_OBSERVER_K_SLIDE);
+    obs->k_slope = (int32_t)(FOC_OBSERVER_K_SLIDE / FOC_OBSERVER_BOUNDARY * 256.0f);
+    obs->lpf = (int32_t)(lpf * 32768.0f);
+    /* 误差Q15（32768对应1rad）-> 角度累加器单位 */
+    obs->pll_kp = (int32_t)(2.0f * FOC_OBSERVER_PLL_DAMPING * wn_ts * OBSERVER_ACC_PER_RAD / 32768.0f);
+    obs->pll_ki = (int32_t)(wn_ts * wn_ts * OBSERVER_ACC_PER_RAD / 32768.0f * 256.0f);
+    /* ω/ωc（Q15） = (speed >> 16) * lag_k >> 8 */
+    obs->lag_k = (int32_t)(65536.0f / OBSERVER_ACC_PER_RAD / lpf * 32768.0f * 256.0f);
+    obs->emf_min = FOC_FLOAT_TO_Q15(FOC_OBSERVER_EMF_MIN);
+    FOC_Observer_Reset(obs);
+}
+
+void FOC_Observer_Reset(FOC_Observer_t *obs)
+{
+    obs->i_est.alpha = 0;
+    obs->i_est.beta = 0;
+    obs->z.alpha = 0;
+    obs->z.beta = 0;
+    obs->emf_alpha = 0;
+    obs->emf_beta = 0;
+    obs->theta = 0;
+    obs->speed = 0;
+    obs->angle = 0;
+}
+
+/* 带边界层的符号函数：z = K * sat((î - i) / φ) */
+static inline FOC_Q15_t Observer_Slide(const FOC_Observer_t *obs, int32_t error)
+{
+    int32_t z = (error * obs->k_slope) >> 8;
+
+    if (z > obs->k_slide)
+    {
+        z = obs->k_slide;
+    }
+    else if (z < -obs->k_slide)
+    {
+        z = -obs->k_slide;
+    }
+    return (FOC_Q15_t)z;
+}
+
+/* 电流模型：î[k+1] = F*î[k] + G*(v - z) */
+static inline FOC_Q15_t Observer_Current(const FOC_Observer_t *obs, FOC_Q15_t i_est, FOC_Q15_t v, FOC_Q15_t z)
+{
+    return FOC_Sat_Q15((obs->f * i_est + obs->g * ((int32_t)v - z)) >> 15);
+}
+
+/********************************************************************************
+ * 观测器单次更新，每个控制周期调用一次
+ * i_AlphaBeta：本周期采样电流
+ * v_AlphaBeta：上一周期计算、在本周期起作用的电压
+ * 返回下一个采样时刻的电角度估计
+ *
+ * 1. 滑模电流观测器：  z = K*sat(î - i)，î = F*î + G*(v - z)
+ * 2. 反电势低通滤波：  ê = ê + ωc*Ts*(z - ê)
+ * 3. PLL：             err = (-êα*cosθ - êβ*sinθ) / |ê| ≈ sin(θr - θ)
+ *                      ω = ω + Ki*err，θ = θ + ω + Kp*err
+ * 4. 滤波滞后补偿：    θout = θ + atan(ω/ωc)
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Angle_t FOC_Observer_Update(FOC_Observer_t *obs, const FOC_Alpha_Beta_Q15_t *i_AlphaBeta, const FOC_Alpha_Beta_Q15_t *v_AlphaBeta)
+{
+    int32_t e_alpha, e_beta, abs_alpha, abs_beta, mag, err, ratio, abs_ratio, comp;
+    FOC_Q15_t sinTheta, cosTheta;
+    FOC_PROFILE_START(FOC_PROFILE_OBSERVER);
+
+    obs->z.alpha = Observer_Slide(obs, (int32_t)obs->i_est.alpha - i_AlphaBeta->alpha);
+    obs->z.beta = Observer_Slide(obs, (int32_t)obs->i_est.beta - i_AlphaBeta->beta);
+    obs->i_est.alpha = Observer_Current(obs, obs->i_est.alpha, v_AlphaBeta->alpha, obs->z.alpha);
+    obs->i_est.beta = Observer_Current(obs, obs->i_est.beta, v_AlphaBeta->beta, obs->z.beta);
+
+    e_alpha = obs->emf_alpha >> 16;
+    e_beta = obs->emf_beta >> 16;
+    obs->emf_alpha += (((int32_t)obs->z.alpha - e_alpha) * obs->lpf) << 1;
+    obs->emf_beta += (((int32_t)obs->z.beta - e_beta) * obs->lpf) << 1;
+    e_alpha = obs->emf_alpha >> 16;
+    e_beta = obs->emf_beta >> 16;
+
+    /* |ê| ≈ max + 3/8 * min（误差<7%，只影响PLL增益） */
+    abs_alpha = (e_alpha < 0) ? -e_alpha : e_alpha;
+    abs_beta = (e_beta < 0) ? -e_beta : e_beta;
+    mag = (abs_alpha > abs_beta) ? (abs_alpha + ((abs_beta * 3) >> 3)) : (abs_beta + ((abs_alpha * 3) >> 3));
+    if (mag < obs->emf_min)
+    {
+        mag = obs->emf_min;
+    }
+
+    FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(obs->theta >> 16), &sinTheta, &cosTheta);
+    err = (-e_alpha * cosTheta - e_beta * sinTheta) >> 15;
+    err = (err << 15) / mag;
+
+    obs->speed += (obs->pll_ki * err) >> 8;
+    obs->theta += (uint32_t)(obs->speed + obs->pll_kp * err);
+
+    /* atan(r) ≈ π/4*r + 0.273*r*(1 - |r|)，|r| <= 1，以16位角度表示 */
+    ratio = ((obs->speed >> 16) * obs->lag_k) >> 8;
+    if (ratio > 32768)
+    {
+        ratio = 32768;
+    }
+    else if (ratio < -32768)
+    {
+        ratio = -32768;
+    }
+    abs_ratio = (ratio < 0) ? -ratio : ratio;
+    comp = (ratio * (8192 + ((2847 * (32768 - abs_ratio)) >> 15))) >> 15;
+
+    obs->angle = (FOC_Angle_t)((obs->theta + ((uint32_t)comp << 16)) >> (32 - FOC_ANGLE_BITS));
+    FOC_PROFILE_STOP(FOC_PROFILE_OBSERVER);
+    return obs->angle;
+}
+
+/* 电角速度估计（rad/s） */
+float FOC_Observer_GetSpeed(const FOC_Observer_t *obs, float ts)
+{
+    return (float)obs->speed / OBSERVER_ACC_PER_RAD / ts;
+}
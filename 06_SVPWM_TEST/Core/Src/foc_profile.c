@@ -0,0 +1,105 @@
+#include "foc_profile.h"
+#include "debug.h"
+
+static FOC_ProfileStat_t Profile_Stat[FOC_PROFILE_STAGE_NUM];
+
+static const char *const Profile_Name[FOC_PROFILE_STAGE_NUM] =
+    {
+    "clarke_park",
+    "pi",
+    "inv_park",
+    "sector",
+    "vector_time",
+    "pwm_counter",
+    "minmax",
+    "overmod",
+    "dpwm",
+    "dtc",
+    "compare_write",
+    "debug",
+    "observer",
+    "vbus",
+    "encoder",
+    "hall_edge",
+    "fieldweak",
+    "mtpa",
+    "control_isr",
+};
+
+/********************************************************************************
+ * 初始化：目标板上使能DWT周期计数器，并清空统计
+ *********************************************************************************/
+void FOC_Profile_Init(void)
+{
+#ifndef FOC_HOST_BUILD
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    FOC_Profile_Reset();
+}
+
+void FOC_Profile_Reset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_PROFILE_STAGE_NUM; i++)
+    {
+        Profile_Stat[i].min = 0xFFFFFFFFu;
+        Profile_Stat[i].max = 0;
+        Profile_Stat[i].count = 0;
+        Profile_Stat[i].total = 0;
+    }
+}
+
+FOC_RAMFUNC void FOC_Profile_Record(FOC_ProfileStage_t stage, uint32_t elapsed)
+{
+    FOC_ProfileStat_t *stat = &Profile_Stat[stage];
+
+    if (elapsed < stat->min)
+    {
+        stat->min = elapsed;
+    }
+    if (elapsed > stat->max)
+    {
+        stat->max = elapsed;
+    }
+    stat->count++;
+    stat->total += elapsed;
+}
+
+const FOC_ProfileStat_t *FOC_Profile_Get(FOC_ProfileStage_t stage)
+{
+    return &Profile_Stat[stage];
+}
+
+/********************************************************************************
+ * 通过USART1输出各阶段 min/max/mean，未执行过的阶段不输出
+ * 统计在中断中更新，此处读取不加锁，个别阶段可能混入一次新样本
+ *********************************************************************************/
+void FOC_Profile_Report(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < FOC_PROFILE_STAGE_NUM; i++)
+    {
+        const FOC_ProfileStat_t *stat = &Profile_Stat[i];
+
+        if (stat->count == 0)
+        {
+            continue;
+        }
+#ifndef FOC_HOST_BUILD
+        /* debug()使用DMA发送，等待上一行发送完成 */
+        while (huart1.gState != HAL_UART_STATE_READY)
+        {
+        }
+#endif
+        debug("%s min:%lu max:%lu mean:%lu %s n:%lu\r\n",
+              Profile_Name[i],
+              (unsigned long)stat->min,
+              (unsigned long)stat->max,
+              (unsigned long)(stat->total / stat->count),
+              FOC_PROFILE_UNIT,
+              (unsigned long)stat->count);
+    }
+}
@@ -0,0 +1,176 @@
+#include "foc_startup.h"
+
+#define STARTUP_ANGLE(theta)    ((FOC_Angle_t)((theta) >> (32 - FOC_ANGLE_BITS)))
+
+/********************************************************************************
+ * 启动初始化，ts为PWM周期（s）
+ * 各步骤时间换算为PWM周期数，并预先计算加速曲线每一段的角度增量
+ *********************************************************************************/
+void FOC_Startup_Init(FOC_Startup_t *st, float ts)
+{
+    uint32_t i;
+    float x;
+
+    st->state = FOC_STARTUP_IDLE;
+    st->n_align = (uint32_t)(FOC_STARTUP_ALIGN_TIME / ts);
+    st->n_segment = (uint32_t)(FOC_STARTUP_RAMP_TIME / ts / (float)FOC_STARTUP_PROFILE_POINTS);
+    if (st->n_segment == 0)
+    {
+        st->n_segment = 1;
+    }
+    st->n_window = (uint32_t)(FOC_STARTUP_LOCK_WINDOW / ts);
+    st->n_timeout = (uint32_t)(FOC_STARTUP_TIMEOUT / ts);
+    st->align_current = FOC_FLOAT_TO_Q15(FOC_STARTUP_ALIGN_CURRENT);
+    st->current = FOC_FLOAT_TO_Q15(FOC_STARTUP_CURRENT);
+    st->speed_ref = FOC_SPEED_TO_Q15(FOC_STARTUP_SPEED);
+    st->lock_drift = (FOC_AngleDiff_t)FOC_Angle_FromRad(FOC_STARTUP_LOCK_DRIFT * (_2PI / 360.0f));
+    st->error_max = (FOC_AngleDiff_t)FOC_Angle_FromRad(FOC_STARTUP_ERROR_MAX * (_2PI / 360.0f));
+    st->done_error = (FOC_AngleDiff_t)FOC_Angle_FromRad(FOC_STARTUP_HANDOVER_DONE * (_2PI / 360.0f));
+
+    /* 分段中点的速度比例x：匀加速 x，S曲线 x - sin(2πx) / 2π */
+    for (i = 0; i <= FOC_STARTUP_PROFILE_POINTS; i++)
+    {
+        x = (i < FOC_STARTUP_PROFILE_POINTS) ? ((float)i + 0.5f) / (float)FOC_STARTUP_PROFILE_POINTS : 1.0f;
+#if FOC_STARTUP_PROFILE == FOC_STARTUP_PROFILE_SCURVE
+        x -= sinf(_2PI * x) / _2PI;
+#endif
+        st->step[i] = (uint32_t)(FOC_STARTUP_SPEED * x * ts / _2PI * 4294967296.0f);
+    }
+}
+
+/* 从电角度0开始定位 */
+void FOC_Startup_Start(FOC_Startup_t *st)
+{
+    st->theta = 0;
+    st->segment = 0;
+    st->count = 0;
+    st->wait = 0;
+    st->lock_count = 0;
+    st->error = 0;
+    st->state = FOC_STARTUP_ALIGN;
+}
+
+FOC_RAMFUNC uint8_t FOC_Startup_Busy(const FOC_Startup_t *st)
+{
+    return (uint8_t)(st->state >= FOC_STARTUP_ALIGN && st->state <= FOC_STARTUP_HANDOVER);
+}
+
+static int32_t Startup_Abs(FOC_AngleDiff_t x)
+{
+    return (x < 0) ? -(int32_t)x : (int32_t)x;
+}
+
+/********************************************************************************
+ * 锁定检查，每个窗口结束时调用一次
+ * 误差在一个窗口内的变化不超过lock_drift、且在±error_max以内时计数，连续FOC_STARTUP_LOCK_COUNT个窗口后开始切换，
+ * 以此时的误差e0计算切换期间保持不变的转矩电流 T0 = I * cos(e0)
+ *********************************************************************************/
+static FOC_RAMFUNC void Startup_CheckLock(FOC_Startup_t *st)
+{
+    FOC_AngleDiff_t drift = FOC_Angle_Diff((FOC_Angle_t)st->error, (FOC_Angle_t)st->error_mark);
+    FOC_Q15_t s, c;
+
+    st->error_mark = st->error;
+    if (Startup_Abs(drift) > st->lock_drift || Startup_Abs(st->error) > st->error_max)
+    {
+        st->lock_count = 0;
+        return;
+    }
+    if (++st->lock_count >= FOC_STARTUP_LOCK_COUNT)
+    {
+        FOC_SinCos_Q15((FOC_Angle_t)st->error, &s, &c);
+        st->torque = (FOC_Q15_t)(((int32_t)st->current * c) >> 15);
+        st->state = FOC_STARTUP_HANDOVER;
+    }
+}
+
+/********************************************************************************
+ * 启动单次更新，在电流环之前每个PWM周期调用一次
+ * est_angle为位置估计（观测器或编码器）的电角度，设置loop的电流给定，返回本周期电流环使用的电角度；
+ * 完成后状态为FOC_STARTUP_DONE，此后直接返回est_angle；锁定超时状态为FOC_STARTUP_FAULT，电流给定清零
+ *********************************************************************************/
+FOC_RAMFUNC FOC_Angle_t FOC_Startup_Update(FOC_Startup_t *st, FOC_CurrentLoop_t *loop, FOC_Angle_t est_angle)
+{
+    FOC_AngleDiff_t d;
+    FOC_Angle_t angle;
+    FOC_Q15_t s, c;
+
+    st->count++;
+    switch (st->state)
+    {
+    case FOC_STARTUP_ALIGN:
+        loop->i_ref.id = st->align_current;
+        loop->i_ref.iq = 0;
+        angle = STARTUP_ANGLE(st->theta);
+        if (st->count >= st->n_align)
+        {
+            /* 开环坐标系后退90°，q轴电流矢量与定位电流同方向，加速开始时转矩从0逐渐增加 */
+            st->theta -= 0x40000000u;
+            st->count = 0;
+            st->state = FOC_STARTUP_RAMP;
+        }
+        break;
+
+    case FOC_STARTUP_RAMP:
+        loop->i_ref.id = 0;
+        loop->i_ref.iq = st->current;
+        st->theta += st->step[st->segment];
+        angle = STARTUP_ANGLE(st->theta);
+        if (st->count >= st->n_segment)
+        {
+            st->count = 0;
+            if (++st->segment >= FOC_STARTUP_PROFILE_POINTS)
+            {
+                st->error_mark = FOC_Angle_Diff(est_angle, angle);
+                st->state = FOC_STARTUP_LOCK;
+            }
+        }
+        break;
+
+    case FOC_STARTUP_LOCK:
+        st->theta += st->step[FOC_STARTUP_PROFILE_POINTS];
+        angle = STARTUP_ANGLE(st->theta);
+        st->error = FOC_Angle_Diff(est_angle, angle);
+        if (++st->wait >= st->n_timeout)
+        {
+            loop->i_ref.iq = 0;
+            st->state = FOC_STARTUP_FAULT;
+        }
+        else if (st->count >= st->n_window)
+        {
+            st->count = 0;
+            Startup_CheckLock(st);
+        }
+        break;
+
+    case FOC_STARTUP_HANDOVER:
+        /* 误差按自身大小的比例衰减，同一电流矢量在估计坐标系内的q轴分量 I * cos(e) 保持为T0 */
+        d = (FOC_AngleDiff_t)(st->error >> FOC_STARTUP_HANDOVER_SHIFT);
+        if (d == 0)
+        {
+            d = (st->error > 0) ? 1 : -1;
+        }
+        st->error = (FOC_AngleDiff_t)(st->error - d);
+        angle = (FOC_Angle_t)(est_angle - (FOC_Angle_t)st->error);
+        FOC_SinCos_Q15((FOC_Angle_t)st->error, &s, &c);
+        loop->i_ref.iq = FOC_Sat_Q15(((int32_t)st->torque << 15) / c);
+        if (Startup_Abs(st->error) <= st->done_error)
+        {
+            st->state = FOC_STARTUP_DONE;
+        }
+        break;
+
+    default:
+        angle = est_angle;
+        break;
+    }
+    return angle;
+}
+
+/* 速度环接管：速度给定取I/f末速度，积分预置为当前iq给定，切换时iq给定连续 */
+void FOC_Startup_Apply(const FOC_Startup_t *st, const FOC_CurrentLoop_t *loop, FOC_Cascade_t *cascade)
+{
+    FOC_Cascade_SetMode(cascade, FOC_CASCADE_MODE_SPEED);
+    cascade->speed_ref = st->speed_ref;
+    FOC_PI_Preset(&cascade->pi_speed, loop->i_ref.iq);
+}
@@ -18,6 +18,7 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "adc.h"
 #include "dma.h"
 #include "tim.h"
 #include "usart.h"
@@ -27,6 +28,9 @@
 /* USER CODE BEGIN Includes */
 #include "debug.h"
 #include "foc_motor_control.h"
+#include "foc_benchmark.h"
+#include "foc_control.h"
+#include "foc_profile.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -94,6 +98,12 @@ int main(void)
   MX_TIM6_Init();
   MX_USART1_UART_Init();
   MX_TIM1_Init();
+  MX_ADC1_Init();
+  MX_TIM3_Init();
+  MX_TIM4_Init();
+  MX_TIM2_Init();
+  MX_TIM8_Init();
+  MX_ADC3_Init();
   /* USER CODE BEGIN 2 */
   __HAL_TIM_ENABLE(&htim6);
   __HAL_TIM_ENABLE_IT(&htim6, TIM_IT_UPDATE);
@@ -103,9 +113,13 @@ int main(void)
   HAL_TIMEx_PWMN_Start(&htim1, TIM_CHANNEL_1);
   HAL_TIMEx_PWMN_Start(&htim1, TIM_CHANNEL_2);
   HAL_TIMEx_PWMN_Start(&htim1, TIM_CHANNEL_3);
-  __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, 500);
-  __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_2, 1000);
-  __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_3, 1500);
+  HAL_TIM_PWM_Start (&htim8, TIM_CHANNEL_1);
+  HAL_TIM_PWM_Start (&htim8, TIM_CHANNEL_2);
+  HAL_TIM_PWM_Start (&htim8, TIM_CHANNEL_3);
+  FOC_Profile_Init();
+  FOC_Control_Init(&FOC_Control[0], &hadc1, &htim1, &htim3, &htim4, &htim2);
+  FOC_Control_Init(&FOC_Control[1], &hadc3, &htim8, NULL, NULL, NULL);
+  FOC_Control_StartPWM();
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -115,9 +129,24 @@ int main(void)
     if (TaskFlag == 1)
     {
       TaskFlag = 0;
+      /* 故障锁存满FOC_FAULT_RECOVER_DELAY且条件解除后自动恢复，超过重试次数锁死 */
+      FOC_Control_FaultTask(&FOC_Control[0]);
+      FOC_Control_FaultTask(&FOC_Control[1]);
+      FOC_Control_Recover(&FOC_Control[0]);
+      FOC_Control_Recover(&FOC_Control[1]);
       // FOC_ClarkePark_Debug();
       // FOC_InverseParkInverseClarke_Debug();
-      FOC_SVPWM_Debug();
+      // FOC_SVPWM_Debug(&FOC_Control[0].svpwm);
+      FOC_Control_Debug(&FOC_Control[0]);
+      // FOC_Benchmark_Transform();
+      // FOC_Benchmark_SinCos();
+      // FOC_Benchmark_SVPWM(&FOC_Control[0].svpwm);
+      // FOC_Benchmark_Observer();
+      // FOC_Benchmark_Atan2();
+      // FOC_Benchmark_CurrentLoop(&FOC_Control[0].svpwm);
+      // FOC_Profile_Report();
+      // FOC_Cascade_Report(&FOC_Control[0].cascade);
+      // FOC_Fault_Report(&FOC_Control[0].fault);
       HAL_GPIO_TogglePin(LED0_GPIO_Port, LED0_Pin);
       HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
     }
@@ -136,6 +165,7 @@ void SystemClock_Config(void)
 {
   RCC_OscInitTypeDef RCC_OscInitStruct = {0};
   RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+  RCC_PeriphCLKInitTypeDef PeriphClkInit = {0};
 
   /** Initializes the RCC Oscillators according to the specified parameters
   * in the RCC_OscInitTypeDef structure.
@@ -165,6 +195,12 @@ void SystemClock_Config(void)
   {
     Error_Handler();
   }
+  PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+  PeriphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV6;
+  if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
+  {
+    Error_Handler();
+  }
 }
 
 /* USER CODE BEGIN 4 */
@@ -147,6 +147,8 @@ Reset_Handler   PROC
                 IMPORT  SystemInit
                 LDR     R0, =SystemInit
                 BLX     R0               
+                ; __main copies ER_RAMFUNC (FOC ISR chain, see 06_SVPWM_TEST.sct) and
+                ; RW_IRAM1 from flash to SRAM, clears ZI data, then calls main()
                 LDR     R0, =__main
                 BX      R0
                 ENDP
@@ -0,0 +1,37 @@
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+/**主机仿真用HAL替身
+ * 仅提供foc_motor_control.c及其头文件用到的类型与宏，
+ * 通过 -ISimulation/Inc 优先于真实HAL被包含
+ */
+#include "stdint.h"
+#include "stdio.h"
+#include "stm32f1xx_hal_tim.h"
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    HAL_UART_STATE_RESET = 0x00U,
+    HAL_UART_STATE_READY = 0x20U
+} HAL_UART_StateTypeDef;
+
+typedef struct
+{
+    volatile HAL_UART_StateTypeDef gState;
+} UART_HandleTypeDef;
+
+/* 毫秒计数由仿真器直接写入uwTick */
+extern volatile uint32_t uwTick;
+uint32_t HAL_GetTick(void);
+
+/* debug()的输出直接写到标准输出 */
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+
+#endif
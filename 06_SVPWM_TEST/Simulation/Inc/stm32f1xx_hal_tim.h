@@ -0,0 +1,88 @@
+#ifndef STM32F1xx_HAL_TIM_H
+#define STM32F1xx_HAL_TIM_H
+/**主机仿真用TIM替身
+ * 寄存器以普通内存代替，__HAL_TIM_SET_COMPARE写入的比较值由仿真器直接读取，
+ * 编码器计数、边沿时间与index捕获由仿真器在每个采样时刻写入；
+ * 刹车输入电平由仿真器写入BKIN，有效时BIF清除后立即重新置位，与硬件一致
+ */
+#include "stdint.h"
+
+typedef struct
+{
+    volatile uint32_t CR1;
+    volatile uint32_t SR;
+    volatile uint32_t CNT;
+    volatile uint32_t PSC;
+    volatile uint32_t ARR;
+    volatile uint32_t RCR;
+    volatile uint32_t CCR1;
+    volatile uint32_t CCR2;
+    volatile uint32_t CCR3;
+    volatile uint32_t CCR4;
+    volatile uint32_t BDTR;
+    volatile uint32_t DIER;
+    volatile uint32_t EGR;
+    volatile uint32_t BKIN;     /*仿真：刹车输入电平（1为有效）*/
+} TIM_TypeDef;
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+#define TIM_CR1_CKD_Pos     (8U)
+#define TIM_CR1_CKD         (0x3UL << TIM_CR1_CKD_Pos)
+#define TIM_BDTR_DTG        (0xFFUL)
+#define TIM_BDTR_BKE        (0x1UL << 12U)
+#define TIM_BDTR_MOE        (0x1UL << 15U)
+#define TIM_SR_CC3IF        (0x1UL << 3U)
+#define TIM_SR_BIF          (0x1UL << 7U)
+#define TIM_FLAG_CC3        TIM_SR_CC3IF
+#define TIM_FLAG_BREAK      TIM_SR_BIF
+#define TIM_DIER_BIE        (0x1UL << 7U)
+#define TIM_IT_BREAK        TIM_DIER_BIE
+#define TIM_EGR_BG          (0x1UL << 7U)
+
+#define TIM_CHANNEL_1       0x00000000U
+#define TIM_CHANNEL_2       0x00000004U
+#define TIM_CHANNEL_3       0x00000008U
+#define TIM_CHANNEL_4       0x0000000CU
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+  (((__CHANNEL__) == TIM_CHANNEL_1) ? ((__HANDLE__)->Instance->CCR1 = (__COMPARE__)) :\
+   ((__CHANNEL__) == TIM_CHANNEL_2) ? ((__HANDLE__)->Instance->CCR2 = (__COMPARE__)) :\
+   ((__CHANNEL__) == TIM_CHANNEL_3) ? ((__HANDLE__)->Instance->CCR3 = (__COMPARE__)) :\
+   ((__HANDLE__)->Instance->CCR4 = (__COMPARE__)))
+
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) \
+  (((__CHANNEL__) == TIM_CHANNEL_1) ? ((__HANDLE__)->Instance->CCR1) :\
+   ((__CHANNEL__) == TIM_CHANNEL_2) ? ((__HANDLE__)->Instance->CCR2) :\
+   ((__CHANNEL__) == TIM_CHANNEL_3) ? ((__HANDLE__)->Instance->CCR3) :\
+   ((__HANDLE__)->Instance->CCR4))
+
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)   ((__HANDLE__)->Instance->CNT)
+
+#define __HAL_TIM_GET_FLAG(__HANDLE__, __FLAG__)    (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+
+/* SR为写0清除，写1无影响；刹车输入仍有效时BIF随即重新置位 */
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__) \
+  ((__HANDLE__)->Instance->SR = ((__HANDLE__)->Instance->SR & ~(__FLAG__)) | \
+                                ((__HANDLE__)->Instance->BKIN ? ((__FLAG__) & TIM_SR_BIF) : 0U))
+
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __INTERRUPT__)      ((__HANDLE__)->Instance->DIER |= (__INTERRUPT__))
+#define __HAL_TIM_DISABLE_IT(__HANDLE__, __INTERRUPT__)     ((__HANDLE__)->Instance->DIER &= ~(__INTERRUPT__))
+#define __HAL_TIM_MOE_ENABLE(__HANDLE__)                    ((__HANDLE__)->Instance->BDTR |= (TIM_BDTR_MOE))
+#define __HAL_TIM_MOE_DISABLE_UNCONDITIONALLY(__HANDLE__)   ((__HANDLE__)->Instance->BDTR &= ~(TIM_BDTR_MOE))
+
+#endif
@@ -0,0 +1,36 @@
+#include "foc_motor_control.h"
+
+/* 替代tim.c、usart.c中的外设句柄与debug缓冲区 */
+static TIM_TypeDef TIM1_Sim;
+static TIM_TypeDef TIM2_Sim;
+static TIM_TypeDef TIM3_Sim;
+static TIM_TypeDef TIM4_Sim;
+static TIM_TypeDef TIM8_Sim;
+TIM_HandleTypeDef htim1 = {&TIM1_Sim, {0}};
+TIM_HandleTypeDef htim2 = {&TIM2_Sim, {0}};
+TIM_HandleTypeDef htim3 = {&TIM3_Sim, {0}};
+TIM_HandleTypeDef htim4 = {&TIM4_Sim, {0}};
+TIM_HandleTypeDef htim8 = {&TIM8_Sim, {0}};
+UART_HandleTypeDef huart1 = {HAL_UART_STATE_READY};
+char debug_buf[128];
+volatile uint32_t uwTick;
+
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    (void)huart;
+    fwrite(pData, 1, Size, stdout);
+    return HAL_OK;
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler\n");
+    while (1)
+    {
+    }
+}
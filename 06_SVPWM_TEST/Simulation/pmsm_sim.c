@@ -0,0 +1,249 @@
+#include "pmsm_sim.h"
+#include "math.h"
+
+#define SIM_2PI     6.283185307179586
+
+void PMSM_Sim_Init(PMSM_State_t *state, const Inverter_Param_t *inv)
+{
+    int i;
+
+    state->id = 0.0;
+    state->iq = 0.0;
+    state->speed = 0.0;
+    state->theta = 0.0;
+    state->position = 0.0;
+    state->udc = inv->supply;
+    state->load = 0.0;
+    state->iu = 0.0;
+    state->iv = 0.0;
+    state->iw = 0.0;
+    state->torque = 0.0;
+    for (i = 0; i < 3; i++)
+    {
+        state->switch_count[i] = 0;
+        state->leg_on[i] = 0;
+    }
+}
+
+/********************************************************************************
+ * 逆变器平均值模型（中心对齐，PWM1模式，CNT < CCR 时上管导通）
+ * 一个PWM周期为 2*ARR 个计数，上管理想导通 2*CCR 个计数；
+ * 每个周期插入的死区期间由续流二极管决定桥臂电压：
+ *   i > 0（流出桥臂）：下管二极管续流，上管少导通一个死区
+ *   i < 0（流入桥臂）：上管二极管续流，上管多导通一个死区
+ * CCR = 0 或 CCR > ARR 时桥臂整个周期不开关（DPWM钳位），没有死区
+ *********************************************************************************/
+static double Inverter_Duty(uint32_t compare, uint32_t period, uint32_t deadtime, double current)
+{
+    double high = 2.0 * (double)compare;
+
+    if (compare == 0)
+    {
+        return 0.0;
+    }
+    if (compare > period)
+    {
+        return 1.0;
+    }
+
+    if (current > 0.0)
+    {
+        high -= (double)deadtime;
+    }
+    else if (current < 0.0)
+    {
+        high += (double)deadtime;
+    }
+    high /= 2.0 * (double)period;
+    if (high < 0.0)
+    {
+        high = 0.0;
+    }
+    else if (high > 1.0)
+    {
+        high = 1.0;
+    }
+    return high;
+}
+
+/********************************************************************************
+ * 电机 + 逆变器 + 直流母线，前向欧拉积分一步
+ *   ud = Rs*id + Ld*did/dt - ωe*Lq*iq
+ *   uq = Rs*iq + Lq*diq/dt + ωe*(Ld*id + ψf)
+ *   Te = 1.5*p*(ψf*iq + (Ld - Lq)*id*iq)
+ *   J*dω/dt = Te - B*ω - TL
+ *   C*dUdc/dt = (Us - Udc)/Rs_supply - Σ(dx*ix)
+ *********************************************************************************/
+void PMSM_Sim_Step(PMSM_State_t *state, const PMSM_Param_t *motor, const Inverter_Param_t *inv,
+                   const uint32_t compare[3], uint32_t period, uint32_t deadtime, double dt)
+{
+    double du, dv, dw, vu, vv, vw, vn;
+    double valpha, vbeta, vd, vq, s, c, we;
+    double did, diq, idc;
+
+    du = Inverter_Duty(compare[0], period, deadtime, state->iu);
+    dv = Inverter_Duty(compare[1], period, deadtime, state->iv);
+    dw = Inverter_Duty(compare[2], period, deadtime, state->iw);
+
+    /* 桥臂电压 -> 相电压（星形连接，去掉中性点电压） */
+    vu = du * state->udc;
+    vv = dv * state->udc;
+    vw = dw * state->udc;
+    vn = (vu + vv + vw) / 3.0;
+    vu -= vn;
+    vv -= vn;
+    vw -= vn;
+
+    /* 等幅值Clarke、Park变换 */
+    valpha = vu;
+    vbeta = (vu + 2.0 * vv) / sqrt(3.0);
+    s = sin(state->theta);
+    c = cos(state->theta);
+    vd = c * valpha + s * vbeta;
+    vq = -s * valpha + c * vbeta;
+
+    we = state->speed * motor->pole_pairs;
+    did = (vd - motor->rs * state->id + we * motor->lq * state->iq) / motor->ld;
+    diq = (vq - motor->rs * state->iq - we * (motor->ld * state->id + motor->flux)) / motor->lq;
+    state->id += did * dt;
+    state->iq += diq * dt;
+
+    state->torque = 1.5 * motor->pole_pairs * (motor->flux * state->iq + (motor->ld - motor->lq) * state->id * state->iq);
+    state->position += state->speed * dt;
+    state->speed += (state->torque - motor->friction * state->speed - state->load) / motor->inertia * dt;
+    state->theta = fmod(state->theta + we * dt, SIM_2PI);
+    if (state->theta < 0.0)
+    {
+        state->theta += SIM_2PI;
+    }
+
+    /* 反Park、反Clarke得到三相电流 */
+    s = sin(state->theta);
+    c = cos(state->theta);
+    state->iu = c * state->id - s * state->iq;
+    state->iv = -0.5 * state->iu + (sqrt(3.0) / 2.0) * (s * state->id + c * state->iq);
+    state->iw = -state->iu - state->iv;
+
+    idc = du * state->iu + dv * state->iv + dw * state->iw;
+    state->udc += ((inv->supply - state->udc) / inv->supply_res - idc) / inv->bus_cap * dt;
+}
+
+/********************************************************************************
+ * 桥臂开关次数统计，每个PWM周期调用一次
+ * 中心对齐PWM1模式：周期起点与终点上管导通（CCR > 0），中间关断（CCR <= ARR），
+ * 0 < CCR <= ARR 时周期内开关两次；周期交界处状态变化另计一次
+ *********************************************************************************/
+void PMSM_Sim_CountSwitching(PMSM_State_t *state, const uint32_t compare[3], uint32_t period)
+{
+    uint8_t on;
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        on = (compare[i] > 0);
+
+        if (on != state->leg_on[i])
+        {
+            state->switch_count[i]++;
+        }
+        if (compare[i] > 0 && compare[i] <= period)
+        {
+            state->switch_count[i] += 2;
+        }
+        state->leg_on[i] = on;
+    }
+}
+
+void Encoder_Sim_Init(Encoder_Sim_t *enc, uint32_t cpr, uint32_t count_offset, double position)
+{
+    enc->cpr = cpr;
+    enc->count_offset = count_offset;
+    enc->position = position;
+    enc->count = (int64_t)floor(position / SIM_2PI * cpr);
+    enc->time = 0.0;
+    enc->edge_time = 0.0;
+    enc->index = 0;
+    enc->index_count = 0;
+}
+
+/********************************************************************************
+ * 编码器边沿生成，与PMSM_Sim_Step同步调用
+ * 转子在[n, n+1)个计数之间时计数值为n；积分步内按线性插值求最后一个边沿的时刻；
+ * 正转经过计数0（index）时锁存进入后的计数值，与TIM3 CH3捕获一致
+ *********************************************************************************/
+void Encoder_Sim_Step(Encoder_Sim_t *enc, double position, double dt)
+{
+    double p0 = enc->position / SIM_2PI * enc->cpr;
+    double p1 = position / SIM_2PI * enc->cpr;
+    int64_t count = (int64_t)floor(p1);
+    int64_t k, edge;
+
+    if (count != enc->count)
+    {
+        /* 正转最后一个边沿在count处，反转在count + 1处 */
+        edge = (count > enc->count) ? count : count + 1;
+        enc->edge_time = enc->time + dt * ((double)edge - p0) / (p1 - p0);
+        for (k = enc->count + 1; k <= count; k++)
+        {
+            if (k % (int64_t)enc->cpr == 0)
+            {
+                enc->index = 1;
+                enc->index_count = enc->count_offset;
+            }
+        }
+        enc->count = count;
+    }
+    enc->position = position;
+    enc->time += dt;
+}
+
+/* 编码器模式定时器的计数值（ARR = cpr - 1） */
+uint32_t Encoder_Sim_Counter(const Encoder_Sim_t *enc)
+{
+    int64_t n = (enc->count + enc->count_offset) % (int64_t)enc->cpr;
+
+    return (uint32_t)((n < 0) ? n + enc->cpr : n);
+}
+
+void Hall_Sim_Init(Hall_Sim_t *hall, double angle)
+{
+    hall->angle = angle;
+    hall->sector = (int64_t)floor(angle / (SIM_2PI / 6.0));
+    hall->time = 0.0;
+    hall->edge_time = 0.0;
+    hall->period = 0.0;
+    hall->edge = 0;
+}
+
+/********************************************************************************
+ * 霍尔边沿生成，与PMSM_Sim_Step同步调用，angle为不回绕的电角度
+ * 每60°一个边沿，积分步内按线性插值求边沿时刻；
+ * period为相邻两个边沿的间隔，即霍尔接口定时器CCR1捕获的值
+ *********************************************************************************/
+void Hall_Sim_Step(Hall_Sim_t *hall, double angle, double dt)
+{
+    double width = SIM_2PI / 6.0;
+    int64_t sector = (int64_t)floor(angle / width);
+    double edge, edge_time;
+
+    if (sector != hall->sector)
+    {
+        edge = (double)((sector > hall->sector) ? sector : sector + 1) * width;
+        edge_time = hall->time + dt * (edge - hall->angle) / (angle - hall->angle);
+        hall->period = edge_time - hall->edge_time;
+        hall->edge_time = edge_time;
+        hall->sector = sector;
+        hall->edge = 1;
+    }
+    hall->angle = angle;
+    hall->time += dt;
+}
+
+/* 霍尔状态（H1 | H2<<1 | H3<<2），H1 = sin(θ) > 0，H2、H3依次滞后120° */
+uint8_t Hall_Sim_State(const Hall_Sim_t *hall)
+{
+    static const uint8_t state[6] = {5, 1, 3, 2, 6, 4};
+    int64_t n = hall->sector % 6;
+
+    return state[(n < 0) ? n + 6 : n];
+}
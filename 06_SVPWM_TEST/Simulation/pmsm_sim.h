@@ -0,0 +1,76 @@
+#ifndef __PMSM_SIM_H__
+#define __PMSM_SIM_H__
+#include "stdint.h"
+
+/*电机参数*/
+typedef struct
+{
+    double rs;          /*相电阻（Ω）*/
+    double ld;          /*d轴电感（H）*/
+    double lq;          /*q轴电感（H）*/
+    double flux;        /*永磁体磁链（Wb）*/
+    double pole_pairs;  /*极对数*/
+    double inertia;     /*转动惯量（kg·m²）*/
+    double friction;    /*粘滞摩擦系数（N·m·s/rad）*/
+} PMSM_Param_t;
+
+/*逆变器与直流母线参数*/
+typedef struct
+{
+    double supply;      /*直流电源电压（V）*/
+    double supply_res;  /*电源内阻（Ω）*/
+    double bus_cap;     /*母线电容（F）*/
+    double timer_clock; /*PWM定时器时钟（Hz）*/
+} Inverter_Param_t;
+
+/*仿真状态*/
+typedef struct
+{
+    double id, iq;      /*dq电流（A）*/
+    double speed;       /*机械角速度（rad/s）*/
+    double theta;       /*电角度（rad，0~2π）*/
+    double position;    /*机械角度（rad，不回绕）*/
+    double udc;         /*母线电压（V）*/
+    double load;        /*负载转矩（N·m）*/
+    double iu, iv, iw;  /*三相电流（A）*/
+    double torque;      /*电磁转矩（N·m）*/
+    uint32_t switch_count[3];   /*各相桥臂开关次数（上管每次开通或关断计一次）*/
+    uint8_t leg_on[3];          /*各相上管在上一个PWM周期结束时的状态*/
+} PMSM_State_t;
+
+/*增量式编码器模型（4倍频计数，index位于机械角度0）*/
+typedef struct
+{
+    uint32_t cpr;           /*每转计数*/
+    uint32_t count_offset;  /*上电时的计数器值，即机械角度0处的计数*/
+    int64_t count;          /*多圈计数（不含count_offset）*/
+    double position;        /*上次更新时的机械角度（rad）*/
+    double time;            /*当前时刻（s）*/
+    double edge_time;       /*最近一个边沿的时刻（s）*/
+    uint8_t index;          /*本采样周期内经过index*/
+    uint32_t index_count;   /*经过index时锁存的计数器值*/
+} Encoder_Sim_t;
+
+/*霍尔传感器模型（120°安装，扇区0起始边沿位于电角度0）*/
+typedef struct
+{
+    double angle;           /*上次更新时的电角度（rad，不回绕）*/
+    int64_t sector;         /*多圈扇区编号*/
+    double time;            /*当前时刻（s）*/
+    double edge_time;       /*最近一个边沿的时刻（s）*/
+    double period;          /*最近两个边沿的间隔（s）*/
+    uint8_t edge;           /*本积分步内出现边沿*/
+} Hall_Sim_t;
+
+void PMSM_Sim_Init(PMSM_State_t *state, const Inverter_Param_t *inv);
+void PMSM_Sim_Step(PMSM_State_t *state, const PMSM_Param_t *motor, const Inverter_Param_t *inv,
+                   const uint32_t compare[3], uint32_t period, uint32_t deadtime, double dt);
+void PMSM_Sim_CountSwitching(PMSM_State_t *state, const uint32_t compare[3], uint32_t period);
+void Encoder_Sim_Init(Encoder_Sim_t *enc, uint32_t cpr, uint32_t count_offset, double position);
+void Encoder_Sim_Step(Encoder_Sim_t *enc, double position, double dt);
+uint32_t Encoder_Sim_Counter(const Encoder_Sim_t *enc);
+void Hall_Sim_Init(Hall_Sim_t *hall, double angle);
+void Hall_Sim_Step(Hall_Sim_t *hall, double angle, double dt);
+uint8_t Hall_Sim_State(const Hall_Sim_t *hall);
+
+#endif
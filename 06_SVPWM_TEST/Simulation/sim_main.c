@@ -0,0 +1,1095 @@
+/********************************************************************************
+ * FOC主机闭环仿真
+ * 未经修改的 Core/Src/foc_motor_control.c 与 PMSM + 逆变器模型闭环运行，
+ * 用于在没有开发板的情况下检查控制器的稳定性与耗时
+ *
+ * 编译（在06_SVPWM_TEST目录下，先按foc_mtpa_config.h、foc_sin_config.h生成MTPA表与正弦表）：
+ *   gcc -ICore/Inc Tools/foc_mtpa_gen.c -lm -o foc_mtpa_gen && ./foc_mtpa_gen Core/Src/foc_mtpa_table.c
+ *   gcc -ICore/Inc Tools/foc_sin_gen.c -lm -o foc_sin_gen && ./foc_sin_gen Core/Src/foc_sin_table.c
+ *   gcc -O2 -std=gnu99 -DFOC_HOST_BUILD -DFOC_PROFILE_ENABLE=1 \
+ *       -ISimulation/Inc -ICore/Inc -ISimulation \
+ *       Simulation/sim_main.c Simulation/pmsm_sim.c Simulation/hal_stub.c \
+ *       Core/Src/foc_motor_control.c Core/Src/foc_observer.c Core/Src/foc_profile.c \
+ *       Core/Src/foc_cascade.c Core/Src/foc_encoder.c Core/Src/foc_hall.c Core/Src/foc_fieldweak.c \
+ *       Core/Src/foc_mtpa.c Core/Src/foc_mtpa_table.c Core/Src/foc_ident.c Core/Src/foc_startup.c \
+ *       Core/Src/foc_sin_table.c Core/Src/foc_fault.c -lm -o foc_sim
+ * 运行：
+ *   ./foc_sim        输出结果摘要，正弦查表误差与耗时、电流跟踪、观测器角度误差、编码器与霍尔的角度与速度误差、
+ *                    母线电压前馈、MTPA查表、DPWM开关次数、位置环定位误差、弱磁转速提升、参数辨识误差
+ *                    开环启动切换、双电机电流跟踪或故障锁存与恢复
+ *                    不达标时返回非0
+ *   ./foc_sim -csv   额外按1ms间隔输出波形（t,id,iq,id_ref,iq_ref,speed,udc,angle_error）
+ * 先以全部16位角度检查FOC_SinCos、FOC_SinCos_Q15相对sin/cos的误差；
+ * 控制使用模型真实角度与母线电压，无感观测器、编码器（由模型生成A/B边沿与index）与霍尔（由模型生成
+ * 边沿并调用边沿中断处理）并行运行，与真实角度比较；
+ * 连续SVPWM跑完整工况后，再以各DPWM方式重复同一工况，比较开关次数与电流误差；
+ * 之后以位置环 -> 速度环（输出经MTPA换算为dq电流给定） -> 电流环串级运行一次定位工况；
+ * 之后降低电源电压，比较不弱磁与弱磁时同一iq给定下的空载转速；
+ * 之后从默认增益开始运行参数辨识，与模型参数比较，并以辨识得到的增益检查电流阶跃；
+ * 之后从静止开环启动，I/f加速后切换到观测器角度与速度环，检查切换过程中转速与iq给定连续；
+ * 之后TIM1与TIM8两个调制器实例交替驱动两台电机，检查实例之间互不影响；
+ * 最后模拟刹车输入与软件刹车，检查故障锁存、恢复条件、恢复时的控制器复位与重试锁死
+ *********************************************************************************/
+#include "foc_motor_control.h"
+#include "foc_observer.h"
+#include "foc_cascade.h"
+#include "foc_encoder.h"
+#include "foc_hall.h"
+#include "foc_fieldweak.h"
+#include "foc_mtpa.h"
+#include "foc_ident.h"
+#include "foc_startup.h"
+#include "foc_fault.h"
+#include "pmsm_sim.h"
+#include "string.h"
+#include "time.h"
+
+#define SIM_TIMER_CLOCK     72000000.0      /*TIM1计数时钟（Hz）*/
+#define SIM_PERIOD          1799u           /*与tim.c中TIM1一致*/
+#define SIM_DEADTIME_DTG    100u            /*与tim.c中TIM1一致*/
+#define SIM_SUBSTEPS        10              /*每个PWM周期的积分步数*/
+#define SIM_TIME            0.5             /*仿真时长（s）*/
+#define SIM_STEP_TIME       0.01            /*iq给定阶跃时刻（s）*/
+#define SIM_IQ_REF          2.0f            /*iq给定（A）*/
+#define SIM_LOAD_TIME       0.3             /*负载阶跃时刻（s）*/
+#define SIM_LOAD            0.03            /*负载转矩（N·m）*/
+#define SIM_CURRENT_KP      0.5f            /*与foc_control.h中电流环增益一致*/
+#define SIM_CURRENT_KI      0.05f
+#define SIM_IQ_TOLERANCE    0.1             /*稳态电流误差上限（A），含死区补偿残余的6次谐波纹波*/
+#define SIM_OBSERVER_SPEED  100.0           /*观测器误差统计的最低电角速度（rad/s）*/
+#define SIM_ANGLE_TOLERANCE 10.0            /*观测器角度误差上限（电角度，°）*/
+#define SIM_OVERMOD_POINTS  4096            /*过调制检查：每个电周期的采样点数*/
+#define SIM_OVERMOD_TOLERANCE 0.01          /*过调制检查：基波幅值相对误差上限*/
+#define SIM_DPWM_REDUCTION  0.25            /*DPWM相对连续SVPWM开关次数的最小降幅*/
+#define SIM_BUS_VOLTAGE     3.0             /*母线电压前馈检查：给定相电压幅值（V）*/
+#define SIM_BUS_TOLERANCE   0.01            /*母线电压前馈检查：基波幅值相对误差上限*/
+#define SIM_POSITION_TURNS  10              /*位置环工况：定位距离（电角度圈数）*/
+#define SIM_POSITION_TOLERANCE 0.05         /*位置环工况：结束时定位误差上限（电角度，rad）*/
+#define SIM_ENCODER_OFFSET  1234u           /*编码器上电计数值，index对齐前角度偏差约1234个计数*/
+#define SIM_ENCODER_ANGLE_TOLERANCE 1.0     /*编码器插值角度误差上限（电角度，°），一个计数为0.36°*/
+#define SIM_ENCODER_SPEED_TOLERANCE 0.005   /*编码器M/T测速稳态相对误差上限*/
+#define SIM_HALL_CLOCK      (SIM_TIMER_CLOCK / (FOC_HALL_TIM_PRESCALER + 1u))  /*霍尔定时器计数时钟（Hz）*/
+#define SIM_HALL_ANGLE_TOLERANCE 3.0        /*霍尔插值角度误差上限（电角度，°）*/
+#define SIM_HALL_SPEED_TOLERANCE 0.01       /*霍尔测速稳态相对误差上限*/
+#define SIM_FW_SUPPLY       10.0            /*弱磁工况：降低电源电压使iq给定下的空载转速受电压限制（V）*/
+#define SIM_FW_TIME         0.3             /*弱磁工况：仿真时长（s）*/
+#define SIM_FW_SPEED_GAIN   0.05            /*弱磁工况：空载转速最小提升比例*/
+#define SIM_FW_MODULATION   1.02            /*弱磁工况：稳态调制度上限（1.0为六边形边界）*/
+#define SIM_MTPA_POINTS     1000            /*MTPA检查：转矩给定点数*/
+#define SIM_MTPA_TOLERANCE  0.002           /*MTPA检查：转矩与电流幅值误差上限（相对电流圆上的MTPA点）*/
+#define SIM_IDENT_TIME      5.0             /*参数辨识：最长仿真时间（s）*/
+#define SIM_IDENT_TOLERANCE 0.05            /*参数辨识：Rs、Ld、Lq、ψ相对误差上限*/
+#define SIM_DUAL_TIME       0.1             /*双电机工况：仿真时长（s）*/
+#define SIM_STARTUP_TIME    2.0             /*开环启动工况：仿真时长（s）*/
+#define SIM_STARTUP_DIP     0.1             /*开环启动工况：切换开始后转速相对I/f末速度的最大偏差*/
+#define SIM_STARTUP_IQ_STEP 0.05            /*开环启动工况：切换过程中相邻PWM周期iq给定的最大变化（A）*/
+#define SIM_SINCOS_REPEAT   16              /*正弦查表耗时统计：全部16位角度的重复次数*/
+#define SIM_SINCOS_MARGIN   (2.0 / 32768.0) /*正弦查表误差上限：表本身的插值误差之外允许的量化与舍入误差*/
+
+static const PMSM_Param_t Motor =
+    {
+    0.5,        /*rs*/
+    0.0008,     /*ld*/
+    0.001,      /*lq*/
+    0.01,       /*flux*/
+    4.0,        /*pole_pairs*/
+    0.00002,    /*inertia*/
+    0.001,      /*friction*/
+};
+
+static const Inverter_Param_t Inverter =
+    {
+    UDC,        /*supply*/
+    0.05,       /*supply_res*/
+    0.00047,    /*bus_cap*/
+    SIM_TIMER_CLOCK,
+};
+
+/*单次闭环仿真结果*/
+typedef struct
+{
+    PMSM_State_t plant;         /*结束时的模型状态（含开关次数）*/
+    double err_d, err_q;        /*最后10%时间内的最大电流跟踪误差（A）*/
+    double udc_min;             /*母线电压最低值（V）*/
+    double angle_err_max;       /*观测器最大角度误差（°）*/
+    double speed_err_max;       /*观测器最大速度误差（rad/s）*/
+    double wall;                /*耗时（s）*/
+    uint32_t steps;             /*PWM周期数*/
+    FOC_Cascade_t cascade;      /*结束时的串级控制状态（含各环执行与超时统计）*/
+    double position_err;        /*结束时的定位误差（电角度，rad）*/
+    uint32_t collide;           /*速度环与位置环落在同一PWM周期的次数*/
+    uint8_t encoder_index;      /*编码器已由index对齐*/
+    double encoder_angle_err;   /*index对齐后编码器最大角度误差（°）*/
+    double encoder_speed_err;   /*最后10%时间内编码器最大速度相对误差*/
+    double hall_angle_err;      /*霍尔最大角度误差（°），统计范围同观测器*/
+    double hall_speed_err;      /*最后10%时间内霍尔最大速度相对误差*/
+    uint32_t hall_errors;       /*霍尔故障状态或跳扇区次数*/
+} Sim_Result_t;
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim2;
+extern TIM_HandleTypeDef htim3;
+extern TIM_HandleTypeDef htim4;
+extern TIM_HandleTypeDef htim8;
+
+static double Sim_WallTime(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/********************************************************************************
+ * 过调制检查（开环，不经过电机模型）
+ * 以给定幅值m旋转一周，由比较值求相电压平均值，取U相基波幅值与m比较；
+ * m以比较值限幅后的可用电压 Udc * span_max 为基值，超过2/π时应输出六步方波（基波2/π）
+ * 另以两个分量均为-32768的满量程矢量（平方和2^31）检查过调制判断没有溢出，输出须被拉回到六边形内
+ * 返回FOC_OVERMOD_SIXSTEP下的最大相对误差
+ *********************************************************************************/
+static double Sim_CheckOvermodulation(FOC_SVPWM_t *svpwm)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(svpwm);
+    static const double m_list[] = {0.50, 0.58, 0.59, 0.60, 0.605, 0.61, 0.62, 0.63, 0.635, 0.65};
+    static const char *const mode_name[] = {"none", "region1", "sixstep"};
+    double err_max = 0.0;
+    double u = (double)pwm->span_max / 32768.0;
+    FOC_Alpha_Beta_Q15_t corner = {-32768, -32768}, out;
+    uint8_t mode;
+    size_t j;
+    int k;
+
+    for (mode = FOC_OVERMOD_NONE; mode <= FOC_OVERMOD_SIXSTEP; mode++)
+    {
+        FOC_SVPWM_SetOvermodulation(svpwm, mode);
+        printf("overmodulation %-7s m/fundamental:", mode_name[mode]);
+        for (j = 0; j < sizeof(m_list) / sizeof(m_list[0]); j++)
+        {
+            double re = 0.0, im = 0.0, fund, target, th;
+
+            for (k = 0; k < SIM_OVERMOD_POINTS; k++)
+            {
+                FOC_Alpha_Beta_Q15_t v;
+                FOC_PWMCounter_t c;
+                double du, dv, dw;
+
+                th = 2.0 * M_PI * k / SIM_OVERMOD_POINTS;
+                v.alpha = FOC_Sat_Q15((int32_t)lround(m_list[j] * u * 32768.0 * cos(th)));
+                v.beta = FOC_Sat_Q15((int32_t)lround(m_list[j] * u * 32768.0 * sin(th)));
+                c = FOC_SVPWM_Modulate_Q15(svpwm, &v);
+                du = (double)c.counter_0 / pwm->period;
+                dv = (double)c.counter_1 / pwm->period;
+                dw = (double)c.counter_2 / pwm->period;
+                du -= (du + dv + dw) / 3.0;
+                re += du * cos(th);
+                im += du * sin(th);
+            }
+            fund = 2.0 * sqrt(re * re + im * im) / SIM_OVERMOD_POINTS / u;
+            target = (m_list[j] < 2.0 / M_PI) ? m_list[j] : 2.0 / M_PI;
+            printf(" %.3f/%.4f", m_list[j], fund);
+            if (mode == FOC_OVERMOD_SIXSTEP && fabs(fund - target) / target > err_max)
+            {
+                err_max = fabs(fund - target) / target;
+            }
+        }
+        printf("\n");
+    }
+    out = FOC_SVPWM_Overmodulate_Q15(svpwm, &corner);
+    printf("overmodulation full-scale corner (%d, %d) -> (%d, %d)\n", corner.alpha, corner.beta, out.alpha, out.beta);
+    if ((double)out.alpha * out.alpha + (double)out.beta * out.beta >= 2.0 * 32768.0 * 32768.0)
+    {
+        err_max = 1.0;
+    }
+    FOC_SVPWM_SetOvermodulation(svpwm, FOC_OVERMOD_MODE);
+    return err_max;
+}
+
+/* 母线电压（V） -> 无符号Q15 */
+static uint16_t Sim_BusVoltage(double udc)
+{
+    double q = udc * (32768.0 / FOC_Q15_BASE);
+
+    return (q > 65535.0) ? 65535u : (uint16_t)lround(q);
+}
+
+/********************************************************************************
+ * 母线电压前馈检查（开环，不经过电机模型）
+ * 不同母线电压下给定同一相电压幅值，由比较值与母线电压求U相电压基波，应与给定一致
+ * 返回最大相对误差
+ *********************************************************************************/
+static double Sim_CheckBusVoltage(FOC_SVPWM_t *svpwm)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(svpwm);
+    static const double udc_list[] = {7.0, 9.0, 12.0, 15.0, 20.0};
+    double err_max = 0.0;
+    size_t j;
+    int k;
+
+    printf("bus feed-forward udc/fundamental:");
+    for (j = 0; j < sizeof(udc_list) / sizeof(udc_list[0]); j++)
+    {
+        double re = 0.0, im = 0.0, fund, th;
+
+        FOC_SVPWM_SetBusVoltage(svpwm, Sim_BusVoltage(udc_list[j]));
+        for (k = 0; k < SIM_OVERMOD_POINTS; k++)
+        {
+            FOC_Alpha_Beta_Q15_t v;
+            FOC_PWMCounter_t c;
+            double du, dv, dw;
+
+            th = 2.0 * M_PI * k / SIM_OVERMOD_POINTS;
+            v.alpha = FOC_FLOAT_TO_Q15((float)(SIM_BUS_VOLTAGE * cos(th)));
+            v.beta = FOC_FLOAT_TO_Q15((float)(SIM_BUS_VOLTAGE * sin(th)));
+            c = FOC_SVPWM_Modulate_Q15(svpwm, &v);
+            du = (double)c.counter_0 / pwm->period;
+            dv = (double)c.counter_1 / pwm->period;
+            dw = (double)c.counter_2 / pwm->period;
+            du = (du - (du + dv + dw) / 3.0) * udc_list[j];
+            re += du * cos(th);
+            im += du * sin(th);
+        }
+        fund = 2.0 * sqrt(re * re + im * im) / SIM_OVERMOD_POINTS;
+        printf(" %.1f/%.4f", udc_list[j], fund);
+        if (fabs(fund - SIM_BUS_VOLTAGE) / SIM_BUS_VOLTAGE > err_max)
+        {
+            err_max = fabs(fund - SIM_BUS_VOLTAGE) / SIM_BUS_VOLTAGE;
+        }
+    }
+    printf("\n");
+    FOC_SVPWM_SetBusVoltage(svpwm, 32768u);
+    return err_max;
+}
+
+/********************************************************************************
+ * 弱磁工况：电源电压降到SIM_FW_SUPPLY，iq给定SIM_IQ_REF空载加速到稳态
+ * 不弱磁时转速受反电势限制，弱磁时注入负id换取电压裕量，稳态转速应更高；
+ * 返回稳态机械角速度，并给出最后10%时间内的最大电流幅值、最大调制度与id给定
+ *********************************************************************************/
+static double Sim_FieldWeak(FOC_SVPWM_t *svpwm, uint8_t enable, double *i_max, double *modulation, double *id_ref)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(svpwm);
+    Inverter_Param_t inverter = Inverter;
+    PMSM_State_t plant;
+    FOC_CurrentLoop_t loop;
+    FOC_FieldWeak_t fw;
+    FOC_U_V_W_Q15_t i_uvw;
+    const FOC_PWMCounter_t *counter;
+    uint32_t compare[3];
+    uint32_t k, steps;
+    double ts = 2.0 * (double)pwm->period / SIM_TIMER_CLOCK;
+    double mag;
+    int s;
+
+    inverter.supply = SIM_FW_SUPPLY;
+    PMSM_Sim_Init(&plant, &inverter);
+    FOC_CurrentLoop_Init(&loop, svpwm, SIM_CURRENT_KP, SIM_CURRENT_KI);
+    FOC_FieldWeak_Init(&fw);
+    FOC_FieldWeak_Enable(&fw, enable);
+    compare[0] = compare[1] = compare[2] = pwm->period >> 1;
+    steps = (uint32_t)(SIM_FW_TIME / ts);
+    *i_max = 0.0;
+    *modulation = 0.0;
+    for (k = 0; k < steps; k++)
+    {
+        loop.i_ref.iq = FOC_FLOAT_TO_Q15(SIM_IQ_REF);
+        i_uvw.iu = FOC_FLOAT_TO_Q15((float)plant.iu);
+        i_uvw.iv = FOC_FLOAT_TO_Q15((float)plant.iv);
+        i_uvw.iw = FOC_FLOAT_TO_Q15((float)plant.iw);
+        FOC_SVPWM_SetBusVoltage(svpwm, Sim_BusVoltage(plant.udc));
+        FOC_FieldWeak_Update(&fw, &loop);
+        counter = FOC_CurrentLoop_Update(&loop, &i_uvw, FOC_Angle_FromRad((float)plant.theta));
+        for (s = 0; s < SIM_SUBSTEPS; s++)
+        {
+            PMSM_Sim_Step(&plant, &Motor, &inverter, compare, pwm->period, pwm->deadtime, ts / SIM_SUBSTEPS);
+        }
+        compare[0] = counter->counter_0;
+        compare[1] = counter->counter_1;
+        compare[2] = counter->counter_2;
+        if (k >= steps - steps / 10)
+        {
+            mag = sqrt(plant.id * plant.id + plant.iq * plant.iq);
+            *i_max = (mag > *i_max) ? mag : *i_max;
+            *modulation = (FOC_SVPWM_GetModulation(svpwm) / 32768.0 > *modulation) ? FOC_SVPWM_GetModulation(svpwm) / 32768.0 : *modulation;
+        }
+    }
+    *id_ref = FOC_Q15_TO_FLOAT(loop.i_ref.id);
+    FOC_SVPWM_SetBusVoltage(svpwm, 32768u);
+    return plant.speed;
+}
+
+/********************************************************************************
+ * 正弦查表检查（开环，不经过电机模型）
+ * 全部16位角度下FOC_SinCos、FOC_SinCos_Q15与sin/cos比较，输出最大误差、均方根误差、每次调用耗时与表的flash占用；
+ * 返回两者最大误差超出线性插值理论误差 (段长)² / 8 的部分，表长、格式、对称性改变时检查同样有效
+ *********************************************************************************/
+static double Sim_CheckSinCos(void)
+{
+    static const char *const format_name[] = {"Q15", "Q31", "float"};
+    FOC_Q15_t s_q15, c_q15;
+    float s_f, c_f;
+    double x, e, bound, err_f = 0.0, err_q = 0.0, sum_f = 0.0, sum_q = 0.0, t_f, t_q;
+    volatile int32_t sink = 0;
+    uint32_t k, n;
+
+    for (k = 0; k < 65536u; k++)
+    {
+        x = (double)k * (2.0 * M_PI / 65536.0);
+        FOC_SinCos(FOC_ANGLE_FROM_U16(k), &s_f, &c_f);
+        FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(k), &s_q15, &c_q15);
+        e = fabs(s_f - sin(x)) > fabs(c_f - cos(x)) ? fabs(s_f - sin(x)) : fabs(c_f - cos(x));
+        err_f = (e > err_f) ? e : err_f;
+        sum_f += e * e;
+        e = fabs(s_q15 / 32768.0 - sin(x)) > fabs(c_q15 / 32768.0 - cos(x)) ? fabs(s_q15 / 32768.0 - sin(x))
+                                                                            : fabs(c_q15 / 32768.0 - cos(x));
+        err_q = (e > err_q) ? e : err_q;
+        sum_q += e * e;
+    }
+
+    t_f = Sim_WallTime();
+    for (n = 0; n < SIM_SINCOS_REPEAT; n++)
+    {
+        for (k = 0; k < 65536u; k++)
+        {
+            FOC_SinCos(FOC_ANGLE_FROM_U16(k), &s_f, &c_f);
+            sink += (int32_t)s_f;
+        }
+    }
+    t_f = (Sim_WallTime() - t_f) * 1e9 / (65536.0 * SIM_SINCOS_REPEAT);
+    t_q = Sim_WallTime();
+    for (n = 0; n < SIM_SINCOS_REPEAT; n++)
+    {
+        for (k = 0; k < 65536u; k++)
+        {
+            FOC_SinCos_Q15(FOC_ANGLE_FROM_U16(k), &s_q15, &c_q15);
+            sink += s_q15;
+        }
+    }
+    t_q = (Sim_WallTime() - t_q) * 1e9 / (65536.0 * SIM_SINCOS_REPEAT);
+
+#if FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER
+    x = 0.5 * M_PI / FOC_SIN_TABLE_SIZE;
+#else
+    x = 2.0 * M_PI / FOC_SIN_TABLE_SIZE;
+#endif
+    bound = x * x / 8.0;
+    printf("sincos %s %s table, %u entries, %u bytes flash: float max %.2e rms %.2e %.1f ns, "
+           "q15 max %.2e rms %.2e %.1f ns (limit %.2e)\n",
+           (FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER) ? "quarter-wave" : "full-wave", format_name[FOC_SIN_FORMAT],
+           FOC_SIN_TABLE_SIZE + 1u, (unsigned)sizeof(FOC_SinTable), err_f, sqrt(sum_f / 65536.0), t_f,
+           err_q, sqrt(sum_q / 65536.0), t_q, bound + SIM_SINCOS_MARGIN);
+    e = (err_f > err_q) ? err_f : err_q;
+    return e - bound;
+}
+
+/* 转矩t（折算q轴电流）、d轴电流id下的电流幅值 */
+static double Sim_MtpaCurrent(double t, double id)
+{
+    double iq = t * Motor.flux / (Motor.flux + (Motor.ld - Motor.lq) * id);
+
+    return sqrt(id * id + iq * iq);
+}
+
+/********************************************************************************
+ * MTPA查表检查（开环，不经过电机模型）
+ * 转矩给定从0到电流圆上的MTPA点等分，查表得到的dq电流代入转矩公式与给定比较，
+ * 电流幅值与按电机参数数值求解的最小电流比较，误差均相对满量程；返回两者中的较大值
+ *********************************************************************************/
+static double Sim_CheckMTPA(void)
+{
+    FOC_D_Q_Q15_t i_ref;
+    double t, id, iq, torque, lo, hi, m1, m2, i_min, torque_err = 0.0, current_err = 0.0;
+    int k, n;
+
+    for (k = 0; k <= SIM_MTPA_POINTS; k++)
+    {
+        t = FOC_MTPA_TorqueMax * k / SIM_MTPA_POINTS;
+        FOC_MTPA_Reference(FOC_FLOAT_TO_Q15((float)t), &i_ref);
+        id = FOC_Q15_TO_FLOAT(i_ref.id);
+        iq = FOC_Q15_TO_FLOAT(i_ref.iq);
+        torque = iq * (Motor.flux + (Motor.ld - Motor.lq) * id) / Motor.flux;
+        /* 同一转矩下电流幅值是id的凸函数，三分法求最小值 */
+        lo = -FOC_MTPA_I_MAX_MA * 0.001;
+        hi = 0.0;
+        for (n = 0; n < 100; n++)
+        {
+            m1 = lo + (hi - lo) / 3.0;
+            m2 = hi - (hi - lo) / 3.0;
+            if (Sim_MtpaCurrent(t, m1) < Sim_MtpaCurrent(t, m2))
+            {
+                hi = m2;
+            }
+            else
+            {
+                lo = m1;
+            }
+        }
+        i_min = Sim_MtpaCurrent(t, lo);
+        torque_err = (fabs(torque - t) > torque_err) ? fabs(torque - t) : torque_err;
+        current_err = (sqrt(id * id + iq * iq) - i_min > current_err) ? sqrt(id * id + iq * iq) - i_min : current_err;
+    }
+    torque_err /= FOC_MTPA_TorqueMax;
+    current_err /= FOC_MTPA_I_MAX_MA * 0.001;
+    printf("mtpa %u segments, %u bytes flash: max torque error %.3f%%, max excess current %.3f%% (limit %.1f%%)\n",
+           FOC_MTPA_TABLE_SIZE, (unsigned)(sizeof(FOC_MTPA_IdTable) + sizeof(FOC_MTPA_FluxTable)),
+           torque_err * 100.0, current_err * 100.0, SIM_MTPA_TOLERANCE * 100.0);
+    return (torque_err > current_err) ? torque_err : current_err;
+}
+
+/********************************************************************************
+ * 参数辨识工况：从默认电流环增益开始运行完整辨识流程，结果与模型参数比较；
+ * 再以辨识得到的增益重复iq阶跃，检查电流跟踪；返回四个参数中的最大相对误差
+ *********************************************************************************/
+static double Sim_Identify(FOC_SVPWM_t *svpwm, double *step_err)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(svpwm);
+    PMSM_State_t plant;
+    FOC_CurrentLoop_t loop;
+    FOC_Observer_t observer;
+    FOC_Ident_t ident;
+    FOC_U_V_W_Q15_t i_uvw;
+    const FOC_PWMCounter_t *counter;
+    uint32_t compare[3];
+    uint32_t k, steps, settle = 0;
+    double ts = 2.0 * (double)pwm->period / SIM_TIMER_CLOCK;
+    double err[4], err_max = 0.0, e;
+    int s, j;
+
+    PMSM_Sim_Init(&plant, &Inverter);
+    FOC_CurrentLoop_Init(&loop, svpwm, SIM_CURRENT_KP, SIM_CURRENT_KI);
+    FOC_Observer_Init(&observer, FOC_OBSERVER_RS, FOC_OBSERVER_LS, FOC_OBSERVER_TS);
+    FOC_Ident_Init(&ident, (float)ts);
+    FOC_Ident_Start(&ident);
+    compare[0] = compare[1] = compare[2] = pwm->period >> 1;
+    steps = (uint32_t)(SIM_IDENT_TIME / ts);
+    *step_err = 0.0;
+    for (k = 0; k < steps; k++)
+    {
+        i_uvw.iu = FOC_FLOAT_TO_Q15((float)plant.iu);
+        i_uvw.iv = FOC_FLOAT_TO_Q15((float)plant.iv);
+        i_uvw.iw = FOC_FLOAT_TO_Q15((float)plant.iw);
+        FOC_SVPWM_SetBusVoltage(svpwm, Sim_BusVoltage(plant.udc));
+        if (FOC_Ident_Busy(&ident))
+        {
+            counter = FOC_Ident_Update(&ident, &loop, &i_uvw);
+            if (ident.state == FOC_IDENT_DONE)
+            {
+                FOC_Ident_Apply(&ident, &loop, &observer);
+                settle = k;
+            }
+        }
+        else
+        {
+            /* 辨识完成后转子自由减速，0.2s后在转动中给iq阶跃 */
+            loop.i_ref.iq = (settle != 0 && k >= settle + (uint32_t)(0.2 / ts)) ? FOC_FLOAT_TO_Q15(SIM_IQ_REF) : 0;
+            counter = FOC_CurrentLoop_Update(&loop, &i_uvw, FOC_Angle_FromRad((float)plant.theta));
+            if (settle != 0 && k >= settle + (uint32_t)(0.25 / ts))
+            {
+                e = fabs(plant.iq - SIM_IQ_REF);
+                *step_err = (e > *step_err) ? e : *step_err;
+                e = fabs(plant.id);
+                *step_err = (e > *step_err) ? e : *step_err;
+            }
+            if (settle == 0 || k >= settle + (uint32_t)(0.3 / ts))
+            {
+                break;
+            }
+        }
+        for (s = 0; s < SIM_SUBSTEPS; s++)
+        {
+            PMSM_Sim_Step(&plant, &Motor, &Inverter, compare, pwm->period, pwm->deadtime, ts / SIM_SUBSTEPS);
+        }
+        compare[0] = counter->counter_0;
+        compare[1] = counter->counter_1;
+        compare[2] = counter->counter_2;
+    }
+    FOC_SVPWM_SetBusVoltage(svpwm, 32768u);
+
+    err[0] = ident.rs / Motor.rs - 1.0;
+    err[1] = ident.ld / Motor.ld - 1.0;
+    err[2] = ident.lq / Motor.lq - 1.0;
+    err[3] = ident.flux / Motor.flux - 1.0;
+    for (j = 0; j < 4; j++)
+    {
+        err_max = (fabs(err[j]) > err_max) ? fabs(err[j]) : err_max;
+    }
+    printf("ident %s in %.2f s: rs %.4f ohm (%+.1f%%), ld %.3f mH (%+.1f%%), lq %.3f mH (%+.1f%%), flux %.5f Wb (%+.1f%%)\n",
+           (ident.state == FOC_IDENT_DONE) ? "done" : "failed", settle * ts, ident.rs, err[0] * 100.0,
+           ident.ld * 1000.0, err[1] * 100.0, ident.lq * 1000.0, err[2] * 100.0, ident.flux, err[3] * 100.0);
+    printf("ident gains kp_d %.3f ki_d %.4f kp_q %.3f ki_q %.4f, iq step error %.3f A (limit %.3f A)\n",
+           ident.kp_d, ident.ki_d, ident.kp_q, ident.ki_q, *step_err, SIM_IQ_TOLERANCE);
+    return (ident.state == FOC_IDENT_DONE) ? err_max : 1.0;
+}
+
+/* 按模型状态写入编码器定时器替身，与电流同一采样时刻 */
+static void Sim_EncoderSample(Encoder_Sim_t *enc)
+{
+    htim3.Instance->CNT = Encoder_Sim_Counter(enc);
+    /* 霍尔接口定时器每个边沿复位，16位回绕 */
+    htim4.Instance->CNT = (uint32_t)((enc->time - enc->edge_time) * SIM_TIMER_CLOCK) & 0xFFFFu;
+    if (enc->index)
+    {
+        htim3.Instance->CCR3 = enc->index_count;
+        htim3.Instance->SR |= TIM_SR_CC3IF;
+        enc->index = 0;
+    }
+}
+
+/********************************************************************************
+ * 闭环仿真：控制使用模型真实角度，观测器、编码器并行运行
+ *   FOC_CASCADE_MODE_CURRENT：  iq阶跃 + 负载阶跃
+ *   FOC_CASCADE_MODE_POSITION： 位置阶跃SIM_POSITION_TURNS圈电角度 + 负载阶跃
+ *********************************************************************************/
+static void Sim_Run(FOC_SVPWM_t *svpwm, int csv, uint8_t mode, Sim_Result_t *r)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(svpwm);
+    PMSM_State_t *plant = &r->plant;
+    FOC_Cascade_t *cascade = &r->cascade;
+    uint32_t speed_runs, position_runs, start;
+    FOC_CurrentLoop_t loop;
+    FOC_Observer_t observer;
+    FOC_Encoder_t encoder;
+    Encoder_Sim_t encoder_sim;
+    FOC_Hall_t hall;
+    Hall_Sim_t hall_sim;
+    FOC_Alpha_Beta_Q15_t v_prev;
+    FOC_U_V_W_Q15_t i_uvw;
+    const FOC_PWMCounter_t *counter;
+    uint32_t compare[3];
+    uint32_t k, csv_div;
+    double ts, t, angle_err, speed_err;
+    int s;
+
+    FOC_CurrentLoop_Init(&loop, svpwm, SIM_CURRENT_KP, SIM_CURRENT_KI);
+    PMSM_Sim_Init(plant, &Inverter);
+    FOC_Observer_Init(&observer, (float)Motor.rs, (float)Motor.lq, FOC_OBSERVER_TS);
+
+    /* 中心对齐：一个PWM周期为 2*ARR 个计数 */
+    ts = 2.0 * (double)pwm->period / SIM_TIMER_CLOCK;
+    Encoder_Sim_Init(&encoder_sim, FOC_ENCODER_CPR, SIM_ENCODER_OFFSET, plant->position);
+    htim3.Instance->SR = 0;
+    Sim_EncoderSample(&encoder_sim);
+    FOC_Encoder_Init(&encoder, &htim3, &htim4, 2u * pwm->period);
+    FOC_Encoder_Start(&encoder);
+    encoder.count = (uint16_t)htim3.Instance->CNT;
+    /* 上电状态当作一个没有扇区时间的边沿 */
+    Hall_Sim_Init(&hall_sim, plant->position * Motor.pole_pairs);
+    FOC_Hall_Init(&hall, &htim2, 2u * pwm->period);
+    FOC_Hall_Start(&hall);
+    FOC_Hall_Edge(&hall, Hall_Sim_State(&hall_sim), 0);
+    FOC_Cascade_Init(cascade, FOC_Angle_FromRad((float)plant->theta), (float)ts);
+    FOC_Cascade_SetMode(cascade, mode);
+    /* 串级工况下速度环输出经MTPA换算为dq电流给定 */
+    cascade->mtpa = (mode != FOC_CASCADE_MODE_CURRENT);
+    r->collide = 0;
+    r->steps = (uint32_t)(SIM_TIME / ts);
+    r->err_d = 0.0;
+    r->err_q = 0.0;
+    r->angle_err_max = 0.0;
+    r->speed_err_max = 0.0;
+    r->encoder_angle_err = 0.0;
+    r->encoder_speed_err = 0.0;
+    r->hall_angle_err = 0.0;
+    r->hall_speed_err = 0.0;
+    r->udc_min = plant->udc;
+    csv_div = (uint32_t)(0.001 / ts);
+    svpwm->htim->Instance->CCR1 = pwm->period >> 1;
+    svpwm->htim->Instance->CCR2 = pwm->period >> 1;
+    svpwm->htim->Instance->CCR3 = pwm->period >> 1;
+
+    r->wall = Sim_WallTime();
+    for (k = 0; k < r->steps; k++)
+    {
+        t = (double)k * ts;
+        if (mode == FOC_CASCADE_MODE_CURRENT)
+        {
+            loop.i_ref.iq = (t >= SIM_STEP_TIME) ? FOC_FLOAT_TO_Q15(SIM_IQ_REF) : 0;
+        }
+        else
+        {
+            cascade->position_ref = (t >= SIM_STEP_TIME) ? ((int64_t)SIM_POSITION_TURNS << FOC_ANGLE_BITS) : 0;
+        }
+        plant->load = (t >= SIM_LOAD_TIME) ? SIM_LOAD : 0.0;
+
+        /* 计数器顶点采样，计算结果在下一个PWM周期生效（与ADC注入中断时序一致） */
+        i_uvw.iu = FOC_FLOAT_TO_Q15((float)plant->iu);
+        i_uvw.iv = FOC_FLOAT_TO_Q15((float)plant->iv);
+        i_uvw.iw = FOC_FLOAT_TO_Q15((float)plant->iw);
+        compare[0] = svpwm->htim->Instance->CCR1;
+        compare[1] = svpwm->htim->Instance->CCR2;
+        compare[2] = svpwm->htim->Instance->CCR3;
+        v_prev = loop.v_AlphaBeta;
+        Sim_EncoderSample(&encoder_sim);
+        FOC_Encoder_Read(&encoder, 0);
+        angle_err = (double)FOC_Angle_Diff(encoder.angle, FOC_Angle_FromRad((float)plant->theta)) * (360.0 / 65536.0 / (1 << (FOC_ANGLE_BITS - 16)));
+        if (encoder.index_found && fabs(angle_err) > r->encoder_angle_err)
+        {
+            r->encoder_angle_err = fabs(angle_err);
+        }
+        /* M/T测速为窗口平均，加速段滞后约一个窗口，只统计最后10%时间内的稳态误差 */
+        if (k >= r->steps - r->steps / 10)
+        {
+            speed_err = fabs(FOC_Encoder_GetSpeed(&encoder, (float)ts) / (plant->speed * Motor.pole_pairs) - 1.0);
+            r->encoder_speed_err = (speed_err > r->encoder_speed_err) ? speed_err : r->encoder_speed_err;
+        }
+        htim2.Instance->CNT = (uint32_t)((hall_sim.time - hall_sim.edge_time) * SIM_HALL_CLOCK) & 0xFFFFu;
+        FOC_Hall_Read(&hall, 0);
+        angle_err = (double)FOC_Angle_Diff(hall.angle, FOC_Angle_FromRad((float)plant->theta)) * (360.0 / 65536.0 / (1 << (FOC_ANGLE_BITS - 16)));
+        if (plant->speed * Motor.pole_pairs > SIM_OBSERVER_SPEED && t > 0.1 && fabs(angle_err) > r->hall_angle_err)
+        {
+            r->hall_angle_err = fabs(angle_err);
+        }
+        if (k >= r->steps - r->steps / 10)
+        {
+            speed_err = fabs(FOC_Hall_GetSpeed(&hall, (float)ts) / (plant->speed * Motor.pole_pairs) - 1.0);
+            r->hall_speed_err = (speed_err > r->hall_speed_err) ? speed_err : r->hall_speed_err;
+        }
+        start = FOC_Profile_Now();
+        FOC_SVPWM_SetBusVoltage(svpwm, Sim_BusVoltage(plant->udc));
+        counter = FOC_CurrentLoop_Update(&loop, &i_uvw, FOC_Angle_FromRad((float)plant->theta));
+        FOC_Observer_Update(&observer, &loop.i_AlphaBeta, &v_prev);
+        speed_runs = cascade->task[FOC_LOOP_SPEED].run_count;
+        position_runs = cascade->task[FOC_LOOP_POSITION].run_count;
+        FOC_Cascade_Update(cascade, &loop, FOC_Angle_FromRad((float)plant->theta));
+        FOC_Cascade_Record(&cascade->task[FOC_LOOP_CURRENT], FOC_Profile_Now() - start);
+        if (speed_runs != cascade->task[FOC_LOOP_SPEED].run_count && position_runs != cascade->task[FOC_LOOP_POSITION].run_count)
+        {
+            r->collide++;
+        }
+        __HAL_TIM_SET_COMPARE(svpwm->htim, TIM_CHANNEL_1, counter->counter_0);
+        __HAL_TIM_SET_COMPARE(svpwm->htim, TIM_CHANNEL_2, counter->counter_1);
+        __HAL_TIM_SET_COMPARE(svpwm->htim, TIM_CHANNEL_3, counter->counter_2);
+
+        PMSM_Sim_CountSwitching(plant, compare, pwm->period);
+        for (s = 0; s < SIM_SUBSTEPS; s++)
+        {
+            PMSM_Sim_Step(plant, &Motor, &Inverter, compare, pwm->period, pwm->deadtime, ts / SIM_SUBSTEPS);
+            Encoder_Sim_Step(&encoder_sim, plant->position, ts / SIM_SUBSTEPS);
+            Hall_Sim_Step(&hall_sim, plant->position * Motor.pole_pairs, ts / SIM_SUBSTEPS);
+            if (hall_sim.edge)
+            {
+                /* 霍尔接口定时器捕获中断：CCR1为16位扇区时间 */
+                FOC_Hall_Edge(&hall, Hall_Sim_State(&hall_sim), (uint16_t)((uint32_t)(hall_sim.period * SIM_HALL_CLOCK) & 0xFFFFu));
+                hall_sim.edge = 0;
+            }
+        }
+
+        /* 观测器输出的是下一个采样时刻的角度 */
+        angle_err = (double)FOC_Angle_Diff(observer.angle, FOC_Angle_FromRad((float)plant->theta)) * (360.0 / 65536.0 / (1 << (FOC_ANGLE_BITS - 16)));
+        if (plant->speed * Motor.pole_pairs > SIM_OBSERVER_SPEED && t > 0.1)
+        {
+            double se = fabs(FOC_Observer_GetSpeed(&observer, (float)ts) - plant->speed * Motor.pole_pairs);
+
+            r->angle_err_max = (fabs(angle_err) > r->angle_err_max) ? fabs(angle_err) : r->angle_err_max;
+            r->speed_err_max = (se > r->speed_err_max) ? se : r->speed_err_max;
+        }
+        if (plant->udc < r->udc_min)
+        {
+            r->udc_min = plant->udc;
+        }
+        /* 统计最后10%时间内的最大跟踪误差 */
+        if (k >= r->steps - r->steps / 10)
+        {
+            double ed = fabs(plant->id - FOC_Q15_TO_FLOAT(loop.i_ref.id));
+            double eq = fabs(plant->iq - FOC_Q15_TO_FLOAT(loop.i_ref.iq));
+
+            r->err_d = (ed > r->err_d) ? ed : r->err_d;
+            r->err_q = (eq > r->err_q) ? eq : r->err_q;
+        }
+        if (csv && (k % csv_div) == 0)
+        {
+            printf("%f,%f,%f,%f,%f,%f,%f,%f\n", t, plant->id, plant->iq, FOC_Q15_TO_FLOAT(loop.i_ref.id),
+                   FOC_Q15_TO_FLOAT(loop.i_ref.iq), plant->speed, plant->udc, angle_err);
+        }
+    }
+    r->wall = Sim_WallTime() - r->wall;
+    r->encoder_index = encoder.index_found;
+    r->hall_errors = hall.error_count;
+    r->position_err = (double)(cascade->position_ref - cascade->position) * (2.0 * M_PI / 65536.0) / (1 << (FOC_ANGLE_BITS - 16));
+}
+
+/********************************************************************************
+ * 开环启动工况：静止 -> 定位 -> I/f加速 -> 观测器锁定 -> 切换到观测器角度与速度环
+ * 统计切换开始后转速相对I/f末速度的最大偏差与切换过程中iq给定的最大单周期变化，检查切换无冲击
+ * （速度环接管后iq给定随观测器角度差分得到的速度反馈波动，不计入）；
+ * 返回结束时的转速相对误差，handover为切换完成时刻（s），未完成时为0
+ *********************************************************************************/
+static double Sim_Startup(FOC_SVPWM_t *svpwm, double *dip, double *iq_step, double *handover)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(svpwm);
+    PMSM_State_t plant;
+    FOC_CurrentLoop_t loop;
+    FOC_Observer_t observer;
+    FOC_Cascade_t cascade;
+    FOC_Startup_t startup;
+    FOC_Alpha_Beta_Q15_t v_prev;
+    FOC_U_V_W_Q15_t i_uvw;
+    const FOC_PWMCounter_t *counter;
+    FOC_Q15_t iq_last = 0;
+    FOC_Angle_t angle;
+    uint8_t state;
+    uint32_t compare[3];
+    uint32_t k, steps;
+    double ts = 2.0 * (double)pwm->period / SIM_TIMER_CLOCK;
+    double e;
+    int s;
+
+    PMSM_Sim_Init(&plant, &Inverter);
+    FOC_CurrentLoop_Init(&loop, svpwm, SIM_CURRENT_KP, SIM_CURRENT_KI);
+    FOC_Observer_Init(&observer, (float)Motor.rs, (float)Motor.lq, (float)ts);
+    FOC_Cascade_Init(&cascade, observer.angle, (float)ts);
+    FOC_Startup_Init(&startup, (float)ts);
+    FOC_Startup_Start(&startup);
+    compare[0] = compare[1] = compare[2] = pwm->period >> 1;
+    steps = (uint32_t)(SIM_STARTUP_TIME / ts);
+    *dip = 0.0;
+    *iq_step = 0.0;
+    *handover = 0.0;
+    for (k = 0; k < steps; k++)
+    {
+        i_uvw.iu = FOC_FLOAT_TO_Q15((float)plant.iu);
+        i_uvw.iv = FOC_FLOAT_TO_Q15((float)plant.iv);
+        i_uvw.iw = FOC_FLOAT_TO_Q15((float)plant.iw);
+        v_prev = loop.v_AlphaBeta;
+        FOC_SVPWM_SetBusVoltage(svpwm, Sim_BusVoltage(plant.udc));
+        angle = observer.angle;
+        state = startup.state;
+        if (FOC_Startup_Busy(&startup))
+        {
+            angle = FOC_Startup_Update(&startup, &loop, angle);
+            if (startup.state == FOC_STARTUP_DONE)
+            {
+                FOC_Startup_Apply(&startup, &loop, &cascade);
+                *handover = k * ts;
+            }
+        }
+        counter = FOC_CurrentLoop_Update(&loop, &i_uvw, angle);
+        FOC_Observer_Update(&observer, &loop.i_AlphaBeta, &v_prev);
+        FOC_Cascade_Update(&cascade, &loop, angle);
+        if (startup.state >= FOC_STARTUP_HANDOVER)
+        {
+            e = fabs(plant.speed * Motor.pole_pairs / FOC_STARTUP_SPEED - 1.0);
+            *dip = (e > *dip) ? e : *dip;
+        }
+        if (state == FOC_STARTUP_HANDOVER)
+        {
+            e = fabs(FOC_Q15_TO_FLOAT(loop.i_ref.iq) - FOC_Q15_TO_FLOAT(iq_last));
+            *iq_step = (e > *iq_step) ? e : *iq_step;
+        }
+        iq_last = loop.i_ref.iq;
+        for (s = 0; s < SIM_SUBSTEPS; s++)
+        {
+            PMSM_Sim_Step(&plant, &Motor, &Inverter, compare, pwm->period, pwm->deadtime, ts / SIM_SUBSTEPS);
+        }
+        compare[0] = counter->counter_0;
+        compare[1] = counter->counter_1;
+        compare[2] = counter->counter_2;
+    }
+    FOC_SVPWM_SetBusVoltage(svpwm, 32768u);
+
+    e = fabs(plant.speed * Motor.pole_pairs / FOC_STARTUP_SPEED - 1.0);
+    printf("startup %s at %.3f s: speed %.1f rad/s (ref %.1f), iq %.3f A, max speed deviation %.1f%% (limit %.1f%%), "
+           "max iq step %.3f A (limit %.2f A)\n", (startup.state == FOC_STARTUP_DONE) ? "handed over" : "failed", *handover,
+           plant.speed * Motor.pole_pairs, FOC_STARTUP_SPEED, plant.iq, *dip * 100.0, SIM_STARTUP_DIP * 100.0,
+           *iq_step, SIM_STARTUP_IQ_STEP);
+    return (startup.state == FOC_STARTUP_DONE) ? e : 1.0;
+}
+
+/* 电机实例：调制器、电流环与模型，双电机工况中两台交替运行 */
+typedef struct
+{
+    FOC_CurrentLoop_t loop;
+    PMSM_State_t plant;
+    uint32_t compare[3];
+    double err_q;               /*最后10%时间内的最大iq跟踪误差（A）*/
+} Sim_Motor_t;
+
+static void Sim_MotorInit(Sim_Motor_t *m, FOC_SVPWM_t *svpwm, float iq_ref)
+{
+    PMSM_Sim_Init(&m->plant, &Inverter);
+    FOC_CurrentLoop_Init(&m->loop, svpwm, SIM_CURRENT_KP, SIM_CURRENT_KI);
+    m->loop.i_ref.iq = FOC_FLOAT_TO_Q15(iq_ref);
+    m->compare[0] = m->compare[1] = m->compare[2] = svpwm->config.period >> 1;
+    m->err_q = 0.0;
+}
+
+/* 一个PWM周期：采样 -> 电流环 -> 模型积分，last为1时统计跟踪误差 */
+static void Sim_MotorStep(Sim_Motor_t *m, double ts, int last)
+{
+    const FOC_PWMConfig_t *pwm = FOC_SVPWM_GetConfig(m->loop.pwm);
+    const FOC_PWMCounter_t *counter;
+    FOC_U_V_W_Q15_t i_uvw;
+    double e;
+    int s;
+
+    i_uvw.iu = FOC_FLOAT_TO_Q15((float)m->plant.iu);
+    i_uvw.iv = FOC_FLOAT_TO_Q15((float)m->plant.iv);
+    i_uvw.iw = FOC_FLOAT_TO_Q15((float)m->plant.iw);
+    FOC_SVPWM_SetBusVoltage(m->loop.pwm, Sim_BusVoltage(m->plant.udc));
+    counter = FOC_CurrentLoop_Update(&m->loop, &i_uvw, FOC_Angle_FromRad((float)m->plant.theta));
+    for (s = 0; s < SIM_SUBSTEPS; s++)
+    {
+        PMSM_Sim_Step(&m->plant, &Motor, &Inverter, m->compare, pwm->period, pwm->deadtime, ts / SIM_SUBSTEPS);
+    }
+    m->compare[0] = counter->counter_0;
+    m->compare[1] = counter->counter_1;
+    m->compare[2] = counter->counter_2;
+    if (last)
+    {
+        e = fabs(m->plant.iq - FOC_Q15_TO_FLOAT(m->loop.i_ref.iq));
+        m->err_q = (e > m->err_q) ? e : m->err_q;
+    }
+}
+
+/********************************************************************************
+ * 双电机工况：TIM1（带死区、连续SVPWM、正iq）与TIM8（无死区、DPWM1、反向iq）
+ * 各自的调制器与电流环交替更新，两台都须跟踪给定；
+ * 再单独运行TIM1电机一次，结果须与交替运行时逐位一致，说明两个实例之间没有共享状态
+ * 返回两台电机中较大的iq跟踪误差，identical为逐位一致标志
+ *********************************************************************************/
+static double Sim_DualMotor(int *identical)
+{
+    static FOC_SVPWM_t svpwm_a, svpwm_b;
+    static Sim_Motor_t a, b, solo;
+    double ts;
+    uint32_t k, steps;
+
+    htim8.Init.Period = SIM_PERIOD;
+    htim8.Instance->ARR = SIM_PERIOD;
+    htim8.Instance->BDTR = 0;
+    FOC_SVPWM_Init(&svpwm_a, &htim1);
+    FOC_SVPWM_Init(&svpwm_b, &htim8);
+    FOC_SVPWM_SetDiscontinuous(&svpwm_a, FOC_DPWM_NONE);
+    FOC_SVPWM_SetDiscontinuous(&svpwm_b, FOC_DPWM_1);
+    ts = 2.0 * (double)svpwm_a.config.period / SIM_TIMER_CLOCK;
+    steps = (uint32_t)(SIM_DUAL_TIME / ts);
+
+    Sim_MotorInit(&a, &svpwm_a, SIM_IQ_REF);
+    Sim_MotorInit(&b, &svpwm_b, -SIM_IQ_REF);
+    for (k = 0; k < steps; k++)
+    {
+        Sim_MotorStep(&a, ts, k >= steps - steps / 10);
+        Sim_MotorStep(&b, ts, k >= steps - steps / 10);
+    }
+
+    FOC_SVPWM_Init(&svpwm_a, &htim1);
+    FOC_SVPWM_SetDiscontinuous(&svpwm_a, FOC_DPWM_NONE);
+    Sim_MotorInit(&solo, &svpwm_a, SIM_IQ_REF);
+    for (k = 0; k < steps; k++)
+    {
+        Sim_MotorStep(&solo, ts, k >= steps - steps / 10);
+    }
+    *identical = (solo.plant.id == a.plant.id && solo.plant.iq == a.plant.iq && solo.plant.speed == a.plant.speed &&
+                  memcmp(&solo.loop.v_dq, &a.loop.v_dq, sizeof(a.loop.v_dq)) == 0);
+
+    printf("dual motor tim1 iq %.3f A (error %.3f A), tim8 dpwm1 no dead time iq %.3f A (error %.3f A), "
+           "tim1 alone %s\n", a.plant.iq, a.err_q, b.plant.iq, b.err_q, *identical ? "identical" : "different");
+    return (a.err_q > b.err_q) ? a.err_q : b.err_q;
+}
+
+/* 刹车中断：与HAL_TIM_IRQHandler相同，先清除BIF再调用回调 */
+static void Sim_BreakIRQ(FOC_Fault_t *fault)
+{
+    TIM_TypeDef *tim = fault->htim->Instance;
+
+    if ((tim->SR & TIM_SR_BIF) && (tim->DIER & TIM_DIER_BIE))
+    {
+        __HAL_TIM_CLEAR_FLAG(fault->htim, TIM_FLAG_BREAK);
+        FOC_Fault_Break(fault);
+    }
+}
+
+/********************************************************************************
+ * 故障管理：TIM1刹车输入有效（硬件清除MOE、置位BIF）-> 锁存过流 -> 恢复条件逐项检查
+ * （锁存时间、刹车输入、母线电压）-> 恢复时串级控制、电流给定与积分复位，MOE与刹车中断重新使能 -> 确认；
+ * 之后以软件刹车（过温）反复故障与恢复，检查重试次数用尽后锁死
+ * 返回不符合预期的检查项数
+ *********************************************************************************/
+static int Sim_Fault(FOC_SVPWM_t *svpwm)
+{
+    static FOC_Fault_t fault;
+    FOC_CurrentLoop_t loop;
+    FOC_Cascade_t cascade;
+    TIM_TypeDef *tim = htim1.Instance;
+    uint16_t udc_high = (uint16_t)(15.0f * (32768.0f / FOC_Q15_BASE));
+    uint8_t wait, active, overvoltage, recovered, temp_active;
+    uint32_t latch_tick;
+    int fail = 0;
+    unsigned n;
+
+    uwTick = 1000;
+    tim->BDTR = SIM_DEADTIME_DTG | TIM_BDTR_BKE | TIM_BDTR_MOE;
+    tim->SR = 0;
+    tim->DIER = 0;
+    tim->BKIN = 0;
+    FOC_CurrentLoop_Init(&loop, svpwm, SIM_CURRENT_KP, SIM_CURRENT_KI);
+    FOC_Cascade_Init(&cascade, 0, FOC_OBSERVER_TS);
+    FOC_Cascade_SetMode(&cascade, FOC_CASCADE_MODE_SPEED);
+    FOC_Fault_Init(&fault, &htim1);
+    fail += (fault.break_input != 1 || (tim->DIER & TIM_DIER_BIE) == 0);
+
+    /* 运行中过流：比较器拉高BKIN，硬件清除MOE */
+    loop.i_ref.iq = FOC_FLOAT_TO_Q15(SIM_IQ_REF);
+    loop.pi_q.integral = 123456;
+    uwTick += 250;
+    tim->BKIN = 1;
+    tim->SR |= TIM_SR_BIF;
+    tim->BDTR &= ~TIM_BDTR_MOE;
+    Sim_BreakIRQ(&fault);
+    Sim_BreakIRQ(&fault);
+    latch_tick = uwTick;
+    fail += (fault.state != FOC_FAULT_STATE_LATCHED || fault.first != FOC_FAULT_OVERCURRENT ||
+             fault.tick != latch_tick || fault.count[0] != 1 || (tim->DIER & TIM_DIER_BIE) != 0);
+
+    /* 恢复条件逐项检查 */
+    uwTick += FOC_FAULT_RECOVER_DELAY / 2;
+    wait = FOC_Fault_Recover(&fault, &loop, &cascade, 32768u);
+    uwTick += FOC_FAULT_RECOVER_DELAY;
+    active = FOC_Fault_Recover(&fault, &loop, &cascade, 32768u);
+    tim->BKIN = 0;
+    overvoltage = FOC_Fault_Recover(&fault, &loop, &cascade, udc_high);
+    fail += (wait != FOC_FAULT_RECOVER_WAIT || active != FOC_FAULT_OVERCURRENT || overvoltage != FOC_FAULT_OVERVOLTAGE ||
+             (tim->BDTR & TIM_BDTR_MOE) != 0);
+    recovered = FOC_Fault_Recover(&fault, &loop, &cascade, 32768u);
+    fail += (recovered != FOC_FAULT_RECOVER_OK || fault.state != FOC_FAULT_STATE_CONFIRM ||
+             (tim->BDTR & TIM_BDTR_MOE) == 0 || (tim->DIER & TIM_DIER_BIE) == 0 || (tim->SR & TIM_SR_BIF) != 0 ||
+             loop.i_ref.iq != 0 || loop.pi_q.integral != 0 || cascade.mode != FOC_CASCADE_MODE_CURRENT);
+    uwTick += FOC_FAULT_CONFIRM_TIME / 2;
+    FOC_Fault_Task(&fault);
+    fail += (fault.state != FOC_FAULT_STATE_CONFIRM);
+    uwTick += FOC_FAULT_CONFIRM_TIME;
+    FOC_Fault_Task(&fault);
+    fail += (fault.state != FOC_FAULT_STATE_NONE || fault.retry != 1);
+    uwTick += FOC_FAULT_RETRY_CLEAR;
+    FOC_Fault_Task(&fault);
+    fail += (fault.retry != 0);
+
+    /* 过温反复故障与恢复，软件刹车不应被记为过流 */
+    temp_active = 0;
+    for (n = 0; fault.state != FOC_FAULT_STATE_LOCKED && n <= FOC_FAULT_RETRY_MAX + 1u; n++)
+    {
+        tim->BDTR |= TIM_BDTR_MOE;
+        FOC_Fault_CheckTemperature(&fault, FOC_FAULT_TEMP_TRIP + 10);
+        Sim_BreakIRQ(&fault);
+        fail += ((tim->BDTR & TIM_BDTR_MOE) != 0 || fault.first != FOC_FAULT_OVERTEMP || fault.count[0] != 1);
+        uwTick += FOC_FAULT_RECOVER_DELAY;
+        temp_active |= FOC_Fault_Recover(&fault, &loop, &cascade, 32768u);
+        FOC_Fault_CheckTemperature(&fault, FOC_FAULT_TEMP_RECOVER - 10);
+        FOC_Fault_Recover(&fault, &loop, &cascade, 32768u);
+        uwTick += FOC_FAULT_CONFIRM_TIME;
+        FOC_Fault_Task(&fault);
+    }
+    fail += (fault.state != FOC_FAULT_STATE_LOCKED || n != FOC_FAULT_RETRY_MAX + 1u ||
+             FOC_Fault_Recover(&fault, &loop, &cascade, 32768u) != FOC_FAULT_RECOVER_DENIED);
+    fail += ((temp_active & FOC_FAULT_OVERTEMP) == 0 || fault.log_count != 1u + n);
+
+    printf("fault break latched at %lu ms, recovery refused: wait 0x%02x, break active 0x%02x, overvoltage 0x%02x, "
+           "recovered 0x%02x, locked after %u faults, log %u entries, %d check(s) failed\n",
+           (unsigned long)latch_tick, wait, active, overvoltage, recovered, n + 1u, (unsigned)fault.log_count, fail);
+    FOC_Fault_Report(&fault);
+
+    tim->BDTR = SIM_DEADTIME_DTG;
+    tim->SR = 0;
+    tim->DIER = 0;
+    return fail;
+}
+
+static uint32_t Sim_SwitchCount(const Sim_Result_t *r)
+{
+    return r->plant.switch_count[0] + r->plant.switch_count[1] + r->plant.switch_count[2];
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *const dpwm_name[] = {"svpwm", "dpwm0", "dpwm1", "dpwmmax"};
+    static FOC_SVPWM_t svpwm;
+    Sim_Result_t r, rd, rp;
+    double overmod_err, bus_err, reduction, dpwm_reduction_min = 1.0, dpwm_err_max = 0.0;
+    double sincos_err, mtpa_err, ident_err, ident_step_err, dual_err;
+    double startup_err, startup_dip, startup_iq_step, startup_time;
+    double fw_speed[2], fw_i_max[2], fw_mod[2], fw_id[2], fw_gain;
+    int csv = (argc > 1) && (strcmp(argv[1], "-csv") == 0);
+    uint8_t mode;
+    int dual_identical, fault_fail;
+
+    htim1.Init.Period = SIM_PERIOD;
+    htim1.Instance->ARR = SIM_PERIOD;
+    htim1.Instance->BDTR = SIM_DEADTIME_DTG;
+    FOC_Profile_Init();
+    FOC_SVPWM_Init(&svpwm, &htim1);
+    sincos_err = Sim_CheckSinCos();
+    overmod_err = Sim_CheckOvermodulation(&svpwm);
+    bus_err = Sim_CheckBusVoltage(&svpwm);
+    FOC_MTPA_Init();
+    mtpa_err = Sim_CheckMTPA();
+
+    FOC_SVPWM_SetDiscontinuous(&svpwm, FOC_DPWM_NONE);
+    Sim_Run(&svpwm, csv, FOC_CASCADE_MODE_CURRENT, &r);
+    printf("simulated %.3f s (%lu PWM periods) in %.3f s, %.0fx real time\n",
+           SIM_TIME, (unsigned long)r.steps, r.wall, SIM_TIME / r.wall);
+    printf("final id %.3f A, iq %.3f A, speed %.1f rad/s, udc min %.2f V\n",
+           r.plant.id, r.plant.iq, r.plant.speed, r.udc_min);
+    printf("steady-state error id %.3f A, iq %.3f A (limit %.3f A)\n", r.err_d, r.err_q, SIM_IQ_TOLERANCE);
+    printf("observer max angle error %.2f deg (limit %.1f deg), max speed error %.1f rad/s\n",
+           r.angle_err_max, SIM_ANGLE_TOLERANCE, r.speed_err_max);
+    printf("encoder (%u CPR) index %s, max angle error %.2f deg (limit %.1f deg), max speed error %.2f%% (limit %.1f%%)\n",
+           FOC_ENCODER_CPR, r.encoder_index ? "found" : "missing", r.encoder_angle_err, SIM_ENCODER_ANGLE_TOLERANCE,
+           r.encoder_speed_err * 100.0, SIM_ENCODER_SPEED_TOLERANCE * 100.0);
+    printf("hall max angle error %.2f deg (limit %.1f deg), max speed error %.2f%% (limit %.1f%%), errors %lu\n",
+           r.hall_angle_err, SIM_HALL_ANGLE_TOLERANCE, r.hall_speed_err * 100.0, SIM_HALL_SPEED_TOLERANCE * 100.0,
+           (unsigned long)r.hall_errors);
+    printf("overmodulation max fundamental error %.2f%% (limit %.1f%%)\n", overmod_err * 100.0, SIM_OVERMOD_TOLERANCE * 100.0);
+    printf("bus feed-forward max fundamental error %.2f%% (limit %.1f%%)\n", bus_err * 100.0, SIM_BUS_TOLERANCE * 100.0);
+    FOC_Profile_Report();
+
+    /* 同一工况下比较各DPWM方式的开关次数 */
+    printf("%-8s switching u:%lu v:%lu w:%lu\n", dpwm_name[FOC_DPWM_NONE], (unsigned long)r.plant.switch_count[0],
+           (unsigned long)r.plant.switch_count[1], (unsigned long)r.plant.switch_count[2]);
+    for (mode = FOC_DPWM_0; mode <= FOC_DPWM_MAX; mode++)
+    {
+        FOC_SVPWM_SetDiscontinuous(&svpwm, mode);
+        Sim_Run(&svpwm, 0, FOC_CASCADE_MODE_CURRENT, &rd);
+        reduction = 1.0 - (double)Sim_SwitchCount(&rd) / (double)Sim_SwitchCount(&r);
+        printf("%-8s switching u:%lu v:%lu w:%lu (-%.1f%%), error id %.3f A, iq %.3f A\n", dpwm_name[mode],
+               (unsigned long)rd.plant.switch_count[0], (unsigned long)rd.plant.switch_count[1],
+               (unsigned long)rd.plant.switch_count[2], reduction * 100.0, rd.err_d, rd.err_q);
+        dpwm_reduction_min = (reduction < dpwm_reduction_min) ? reduction : dpwm_reduction_min;
+        dpwm_err_max = (rd.err_d > dpwm_err_max) ? rd.err_d : dpwm_err_max;
+        dpwm_err_max = (rd.err_q > dpwm_err_max) ? rd.err_q : dpwm_err_max;
+    }
+    FOC_SVPWM_SetDiscontinuous(&svpwm, FOC_DPWM_MODE);
+
+    /* 位置环 -> 速度环 -> MTPA -> 电流环 */
+    Sim_Run(&svpwm, 0, FOC_CASCADE_MODE_POSITION, &rp);
+    /* 静止保持时相电流过零缓慢，死区补偿过渡带内id纹波较大，只检查iq跟踪 */
+    printf("position %d turns: error %.4f rad (limit %.2f rad), speed %.1f rad/s, error id %.3f A, iq %.3f A, "
+           "speed/position loops in the same period: %lu\n", SIM_POSITION_TURNS, rp.position_err, SIM_POSITION_TOLERANCE,
+           rp.plant.speed, rp.err_d, rp.err_q, (unsigned long)rp.collide);
+    FOC_Cascade_Report(&rp.cascade);
+
+    /* 同一iq给定下比较不弱磁与弱磁的空载转速 */
+    for (mode = 0; mode < 2; mode++)
+    {
+        fw_speed[mode] = Sim_FieldWeak(&svpwm, mode, &fw_i_max[mode], &fw_mod[mode], &fw_id[mode]);
+        printf("field weakening %-3s at %.1f V: speed %.1f rad/s, id_ref %.3f A, max |i| %.3f A (limit %.1f A), "
+               "max modulation %.3f\n", mode ? "on" : "off", SIM_FW_SUPPLY, fw_speed[mode], fw_id[mode], fw_i_max[mode],
+               FOC_FW_I_MAX, fw_mod[mode]);
+    }
+    fw_gain = fw_speed[1] / fw_speed[0] - 1.0;
+    printf("field weakening speed gain %.1f%% (min %.1f%%)\n", fw_gain * 100.0, SIM_FW_SPEED_GAIN * 100.0);
+
+    ident_err = Sim_Identify(&svpwm, &ident_step_err);
+    startup_err = Sim_Startup(&svpwm, &startup_dip, &startup_iq_step, &startup_time);
+    dual_err = Sim_DualMotor(&dual_identical);
+    fault_fail = Sim_Fault(&svpwm);
+
+    return (sincos_err < SIM_SINCOS_MARGIN && r.err_d < SIM_IQ_TOLERANCE && r.err_q < SIM_IQ_TOLERANCE && r.angle_err_max < SIM_ANGLE_TOLERANCE &&
+            r.encoder_index && r.encoder_angle_err < SIM_ENCODER_ANGLE_TOLERANCE &&
+            r.encoder_speed_err < SIM_ENCODER_SPEED_TOLERANCE && r.hall_angle_err < SIM_HALL_ANGLE_TOLERANCE &&
+            r.hall_speed_err < SIM_HALL_SPEED_TOLERANCE && r.hall_errors == 0 && overmod_err < SIM_OVERMOD_TOLERANCE && bus_err < SIM_BUS_TOLERANCE && dpwm_err_max < SIM_IQ_TOLERANCE &&
+            dpwm_reduction_min > SIM_DPWM_REDUCTION && fabs(rp.position_err) < SIM_POSITION_TOLERANCE &&
+            rp.err_q < SIM_IQ_TOLERANCE && rp.collide == 0 && fw_gain > SIM_FW_SPEED_GAIN &&
+            fw_i_max[1] <= FOC_FW_I_MAX && fw_mod[1] < SIM_FW_MODULATION && mtpa_err < SIM_MTPA_TOLERANCE &&
+            ident_err < SIM_IDENT_TOLERANCE && ident_step_err < SIM_IQ_TOLERANCE &&
+            dual_err < SIM_IQ_TOLERANCE && dual_identical && fault_fail == 0 &&
+            startup_err < SIM_STARTUP_DIP && startup_dip < SIM_STARTUP_DIP && startup_iq_step < SIM_STARTUP_IQ_STEP) ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#ifndef __FOC_GEN_OUTPUT_H__
+#define __FOC_GEN_OUTPUT_H__
+/**生成工具共用的输出处理（主机端，各工具单文件编译，函数直接定义在这里）
+ * 先写到<输出>.tmp，写完后与已有文件逐字节比较：内容相同时删除临时文件，已提交的文件
+ * 保持不动（工作区不会变脏，Keil也不会因时间戳变化重新编译）；不同时才替换
+ * 以二进制方式写入，Windows与Linux上生成的换行一致
+ * 任何一步失败都在stderr上给出原因并返回非0，由工具作为退出码返回，Keil编译前步骤据此停止编译
+ */
+#include "stdio.h"
+#include "string.h"
+
+#define GEN_PATH_MAX    512
+
+static char Gen_TmpPath[GEN_PATH_MAX];
+
+/* 打开临时输出文件，失败返回NULL */
+static FILE *Gen_Open(const char *path)
+{
+    FILE *f;
+
+    if (strlen(path) + sizeof(".tmp") > GEN_PATH_MAX)
+    {
+        fprintf(stderr, "%s: path too long\n", path);
+        return NULL;
+    }
+    sprintf(Gen_TmpPath, "%s.tmp", path);
+    f = fopen(Gen_TmpPath, "wb");
+    if (f == NULL)
+    {
+        perror(Gen_TmpPath);
+    }
+    return f;
+}
+
+/* 两个文件内容相同返回1，任一文件不存在或内容不同返回0 */
+static int Gen_SameContent(const char *a, const char *b)
+{
+    FILE *fa = fopen(a, "rb");
+    FILE *fb = fopen(b, "rb");
+    int ca, cb, same = 0;
+
+    if (fa != NULL && fb != NULL)
+    {
+        do
+        {
+            ca = fgetc(fa);
+            cb = fgetc(fb);
+        } while (ca == cb && ca != EOF);
+        same = (ca == cb);
+    }
+    if (fa != NULL)
+    {
+        fclose(fa);
+    }
+    if (fb != NULL)
+    {
+        fclose(fb);
+    }
+    return same;
+}
+
+/* 关闭临时文件，内容有变化时替换path；成功返回0 */
+static int Gen_Close(FILE *f, const char *path)
+{
+    int err = ferror(f);
+
+    if (fclose(f) != 0 || err)
+    {
+        fprintf(stderr, "%s: write failed\n", Gen_TmpPath);
+        remove(Gen_TmpPath);
+        return 1;
+    }
+    if (Gen_SameContent(Gen_TmpPath, path))
+    {
+        remove(Gen_TmpPath);
+        printf("%s: up to date\n", path);
+        return 0;
+    }
+    /* Windows上rename不覆盖已有文件 */
+    remove(path);
+    if (rename(Gen_TmpPath, path) != 0)
+    {
+        perror(path);
+        return 1;
+    }
+    printf("%s: updated\n", path);
+    return 0;
+}
+
+#endif
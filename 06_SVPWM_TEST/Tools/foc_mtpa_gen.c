@@ -0,0 +1,145 @@
+/********************************************************************************
+ * MTPA查表生成工具（主机端）
+ * 按foc_mtpa_config.h中的电机参数离线求解，生成Core/Src/foc_mtpa_table.c
+ *
+ * 编译运行（在06_SVPWM_TEST目录下）：
+ *   gcc -ICore/Inc Tools/foc_mtpa_gen.c -lm -o foc_mtpa_gen && ./foc_mtpa_gen Core/Src/foc_mtpa_table.c
+ *
+ * 转矩以折算q轴电流表示：T = 1.5 * p * ψ * i_t，与表贴式电机的iq给定单位相同
+ *   i_t = iq * (ψ + (Ld - Lq) * id) / ψ
+ * MTPA（ΔL = Lq - Ld > 0）：id = ψ / (2ΔL) - sqrt(ψ² / (4ΔL²) + iq²)
+ * IdTable：  i_t在[0, TorqueMax]上等分，表项为MTPA的id / Imax
+ * FluxTable：id在[-Imax, 0]上等分，表项为ψ / (ψ + (Ld - Lq) * id)，即 iq = i_t * 表项，
+ *            弱磁等偏离MTPA的id同样适用
+ *********************************************************************************/
+#include "stdio.h"
+#include "math.h"
+#include "foc_mtpa_config.h"
+#include "foc_gen_output.h"
+
+#define GEN_LD      (FOC_MTPA_LD_UH * 1e-6)
+#define GEN_LQ      (FOC_MTPA_LQ_UH * 1e-6)
+#define GEN_FLUX    (FOC_MTPA_FLUX_UWB * 1e-6)
+#define GEN_I_MAX   (FOC_MTPA_I_MAX_MA * 1e-3)
+#define GEN_N       ((int)FOC_MTPA_TABLE_SIZE)
+
+/* 给定iq下的MTPA id */
+static double Gen_MtpaId(double iq)
+{
+    double dl = GEN_LQ - GEN_LD;
+
+    if (dl <= 0.0)
+    {
+        return 0.0;
+    }
+    return GEN_FLUX / (2.0 * dl) - sqrt(GEN_FLUX * GEN_FLUX / (4.0 * dl * dl) + iq * iq);
+}
+
+/* 折算q轴电流 */
+static double Gen_Torque(double id, double iq)
+{
+    return iq * (GEN_FLUX + (GEN_LD - GEN_LQ) * id) / GEN_FLUX;
+}
+
+/* MTPA轨迹上i_t随iq单调增加，二分求解 */
+static double Gen_MtpaIq(double torque)
+{
+    double lo = 0.0, hi = GEN_I_MAX, mid;
+    int i;
+
+    for (i = 0; i < 60; i++)
+    {
+        mid = 0.5 * (lo + hi);
+        if (Gen_Torque(Gen_MtpaId(mid), mid) < torque)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+static void Gen_Table(FILE *f, const char *name, const char *comment, const double *value, double scale)
+{
+    int i;
+    double q;
+
+    fprintf(f, "/* %s */\n", comment);
+    fprintf(f, "const FOC_MTPA_Entry_t %s[FOC_MTPA_TABLE_SIZE + 1] FOC_RAMDATA =\n    {\n", name);
+    for (i = 0; i <= GEN_N; i++)
+    {
+        /* 表项饱和到Q(15 + FOC_MTPA_FRAC_BITS)的范围 */
+        q = floor(value[i] * scale + 0.5);
+        if (q > 32768.0 * (1 << FOC_MTPA_FRAC_BITS) - 1.0)
+        {
+            q = 32768.0 * (1 << FOC_MTPA_FRAC_BITS) - 1.0;
+        }
+        fprintf(f, "%s%.0f,%s", (i % 8) == 0 ? "    " : "", q, (i % 8) == 7 || i == GEN_N ? "\n" : " ");
+    }
+    fprintf(f, "};\n\n");
+}
+
+int main(int argc, char *argv[])
+{
+    static double id[GEN_N + 1], ratio[GEN_N + 1];
+    double iq, id_max, torque_max;
+    FILE *f;
+    int i;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <output.c>\n", argv[0]);
+        return 2;
+    }
+    if (GEN_FLUX <= 0.0 || GEN_I_MAX <= 0.0)
+    {
+        fprintf(stderr, "flux and current limit must be positive\n");
+        return 1;
+    }
+
+    /* 电流圆上的MTPA点：iq按id² + iq² = Imax²代入MTPA条件解得 */
+    if (GEN_LQ > GEN_LD)
+    {
+        double dl = GEN_LQ - GEN_LD;
+
+        id_max = (GEN_FLUX - sqrt(GEN_FLUX * GEN_FLUX + 8.0 * dl * dl * GEN_I_MAX * GEN_I_MAX)) / (4.0 * dl);
+    }
+    else
+    {
+        id_max = 0.0;
+    }
+    torque_max = Gen_Torque(id_max, sqrt(GEN_I_MAX * GEN_I_MAX - id_max * id_max));
+
+    for (i = 0; i <= GEN_N; i++)
+    {
+        iq = Gen_MtpaIq(torque_max * i / GEN_N);
+        id[i] = Gen_MtpaId(iq) / GEN_I_MAX;
+        ratio[i] = GEN_FLUX / (GEN_FLUX + (GEN_LD - GEN_LQ) * (GEN_I_MAX * i / GEN_N - GEN_I_MAX));
+    }
+
+    f = Gen_Open(argv[1]);
+    if (f == NULL)
+    {
+        return 1;
+    }
+    fprintf(f, "/* 由Tools/foc_mtpa_gen.c生成，不要手工修改 */\n");
+    fprintf(f, "#include \"foc_mtpa_config.h\"\n\n");
+    fprintf(f, "#if FOC_MTPA_LD_UH != %d || FOC_MTPA_LQ_UH != %d || FOC_MTPA_FLUX_UWB != %d || FOC_MTPA_I_MAX_MA != %d || \\\n",
+            FOC_MTPA_LD_UH, FOC_MTPA_LQ_UH, FOC_MTPA_FLUX_UWB, FOC_MTPA_I_MAX_MA);
+    fprintf(f, "    FOC_MTPA_TABLE_BITS != %d || FOC_MTPA_FRAC_BITS != %d\n", FOC_MTPA_TABLE_BITS, FOC_MTPA_FRAC_BITS);
+    fprintf(f, "#error \"foc_mtpa_table.c does not match foc_mtpa_config.h, rerun Tools/foc_mtpa_gen\"\n#endif\n\n");
+    fprintf(f, "/* 电流圆上的MTPA点：id %.4f A，折算q轴电流 %.4f A */\n", id_max, torque_max);
+    fprintf(f, "const float FOC_MTPA_TorqueMax = %.6ff;\n\n", torque_max);
+    Gen_Table(f, "FOC_MTPA_IdTable", "MTPA id / Imax，Q(15 + FOC_MTPA_FRAC_BITS)，i_t从0到FOC_MTPA_TorqueMax等分",
+              id, 32768.0 * (1 << FOC_MTPA_FRAC_BITS));
+    Gen_Table(f, "FOC_MTPA_FluxTable", "ψ / (ψ + (Ld - Lq) * id)，Q(14 + FOC_MTPA_FRAC_BITS)，id从-Imax到0等分",
+              ratio, 16384.0 * (1 << FOC_MTPA_FRAC_BITS));
+    if (Gen_Close(f, argv[1]) != 0)
+    {
+        return 1;
+    }
+    return 0;
+}
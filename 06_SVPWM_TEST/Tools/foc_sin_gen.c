@@ -0,0 +1,128 @@
+/********************************************************************************
+ * 正弦查表生成工具（主机端）
+ * 按foc_sin_config.h中的表长、格式与对称性生成Core/Src/foc_sin_table.c
+ *
+ * 编译运行（在06_SVPWM_TEST目录下）：
+ *   gcc -ICore/Inc Tools/foc_sin_gen.c -lm -o foc_sin_gen && ./foc_sin_gen Core/Src/foc_sin_table.c
+ * 配置可在命令行覆盖后比较不同取舍，例如：
+ *   gcc -ICore/Inc -DFOC_SIN_TABLE_BITS=9 -DFOC_SIN_FORMAT=1 Tools/foc_sin_gen.c -lm -o foc_sin_gen
+ * （固件与仿真须使用同一组定义）
+ *
+ * 表项为 sin(span * i / N)，i = 0 ~ N，1/4周期表span = π/2，整周期表span = 2π；
+ * 终端输出量化后的表在线性插值下相对sin的最大误差、均方根误差（在表范围内按每段64点统计）与flash占用
+ *********************************************************************************/
+#include "stdio.h"
+#include "math.h"
+#include "foc_sin_config.h"
+#include "foc_gen_output.h"
+
+#define GEN_N           ((int)FOC_SIN_TABLE_SIZE)
+#define GEN_SUBSTEPS    64
+
+#if FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER
+#define GEN_SPAN        (0.5 * M_PI)
+#define GEN_SYMMETRY    "quarter-wave"
+#else
+#define GEN_SPAN        (2.0 * M_PI)
+#define GEN_SYMMETRY    "full-wave"
+#endif
+
+#if FOC_SIN_FORMAT == FOC_SIN_FORMAT_Q15
+#define GEN_SCALE       32768.0
+#define GEN_FORMAT      "Q15"
+#define GEN_PER_LINE    10
+#elif FOC_SIN_FORMAT == FOC_SIN_FORMAT_Q31
+#define GEN_SCALE       2147483648.0
+#define GEN_FORMAT      "Q31"
+#define GEN_PER_LINE    6
+#else
+#define GEN_SCALE       1.0
+#define GEN_FORMAT      "float"
+#define GEN_PER_LINE    6
+#endif
+
+/* 量化为表项格式，定点饱和到±(2^n - 1)，返回表项代表的实际值 */
+static double Gen_Quantize(double v)
+{
+#if FOC_SIN_FORMAT == FOC_SIN_FORMAT_FLOAT
+    return (double)(float)v;
+#else
+    double q = floor(v * GEN_SCALE + 0.5);
+
+    if (q > GEN_SCALE - 1.0)
+    {
+        q = GEN_SCALE - 1.0;
+    }
+    else if (q < -(GEN_SCALE - 1.0))
+    {
+        q = -(GEN_SCALE - 1.0);
+    }
+    return q / GEN_SCALE;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    static double table[GEN_N + 1];
+    double x, v, e, err_max = 0.0, err_sum = 0.0;
+    FILE *f;
+    int i, k;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <output.c>\n", argv[0]);
+        return 2;
+    }
+    for (i = 0; i <= GEN_N; i++)
+    {
+        table[i] = Gen_Quantize(sin(GEN_SPAN * i / GEN_N));
+    }
+
+    /* 与FOC_SinCos相同的线性插值 */
+    for (i = 0; i < GEN_N; i++)
+    {
+        for (k = 0; k < GEN_SUBSTEPS; k++)
+        {
+            x = (double)k / GEN_SUBSTEPS;
+            v = table[i] + x * (table[i + 1] - table[i]);
+            e = fabs(v - sin(GEN_SPAN * (i + x) / GEN_N));
+            err_max = (e > err_max) ? e : err_max;
+            err_sum += e * e;
+        }
+    }
+
+    f = Gen_Open(argv[1]);
+    if (f == NULL)
+    {
+        return 1;
+    }
+    fprintf(f, "/* 由Tools/foc_sin_gen.c生成，不要手工修改 */\n");
+    fprintf(f, "#include \"foc_sin_config.h\"\n\n");
+    fprintf(f, "#if FOC_SIN_FORMAT != %d || FOC_SIN_SYMMETRY != %d || FOC_SIN_TABLE_BITS != %d\n",
+            FOC_SIN_FORMAT, FOC_SIN_SYMMETRY, FOC_SIN_TABLE_BITS);
+    fprintf(f, "#error \"foc_sin_table.c does not match foc_sin_config.h, rerun Tools/foc_sin_gen\"\n#endif\n\n");
+    fprintf(f, "/* %s正弦，%d等分0~%s，%s，插值最大误差 %.2e，均方根误差 %.2e */\n",
+            (FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER) ? "1/4周期" : "整周期", GEN_N,
+            (FOC_SIN_SYMMETRY == FOC_SIN_SYMMETRY_QUARTER) ? "π/2" : "2π", GEN_FORMAT,
+            err_max, sqrt(err_sum / (GEN_N * GEN_SUBSTEPS)));
+    fprintf(f, "const FOC_SinEntry_t FOC_SinTable[FOC_SIN_TABLE_SIZE + 1] FOC_RAMDATA =\n    {\n");
+    for (i = 0; i <= GEN_N; i++)
+    {
+#if FOC_SIN_FORMAT == FOC_SIN_FORMAT_FLOAT
+        fprintf(f, "%s%.8ff,", (i % GEN_PER_LINE) == 0 ? "    " : "", table[i]);
+#else
+        fprintf(f, "%s%.0f,", (i % GEN_PER_LINE) == 0 ? "    " : "", table[i] * GEN_SCALE);
+#endif
+        fprintf(f, "%s", (i % GEN_PER_LINE) == GEN_PER_LINE - 1 || i == GEN_N ? "\n" : " ");
+    }
+    fprintf(f, "};\n");
+    if (Gen_Close(f, argv[1]) != 0)
+    {
+        return 1;
+    }
+
+    printf("foc_sin_gen: %s %s table, %d entries, %u bytes flash, interpolation error max %.2e rms %.2e\n",
+           GEN_SYMMETRY, GEN_FORMAT, GEN_N + 1, (unsigned)((GEN_N + 1) * sizeof(FOC_SinEntry_t)),
+           err_max, sqrt(err_sum / (GEN_N * GEN_SUBSTEPS)));
+    return 0;
+}